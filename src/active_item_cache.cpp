@@ -4,6 +4,7 @@
 #include <numeric>
 #include <utility>
 
+#include "calendar.h"
 #include "item.h"
 #include "item_pocket.h"
 #include "safe_reference.h"
@@ -26,6 +27,129 @@ bool item_reference::has_watertight_container() const
     } );
 }
 
+active_item_cache::active_item_cache()
+{
+    heads.fill( -1 );
+}
+
+int active_item_cache::turn_now()
+{
+    return to_turns<int>( calendar::turn - calendar::turn_zero );
+}
+
+void active_item_cache::link( const int id, const int slot )
+{
+    node &n = nodes[id];
+    n.slot = slot;
+    n.prev = -1;
+    n.next = heads[slot];
+    if( n.next >= 0 ) {
+        nodes[n.next].prev = id;
+    }
+    heads[slot] = id;
+}
+
+void active_item_cache::unlink( const int id )
+{
+    node &n = nodes[id];
+    if( n.prev >= 0 ) {
+        nodes[n.prev].next = n.next;
+    } else {
+        heads[n.slot] = n.next;
+    }
+    if( n.next >= 0 ) {
+        nodes[n.next].prev = n.prev;
+    }
+    n.prev = -1;
+    n.next = -1;
+}
+
+int active_item_cache::take( const int slot )
+{
+    const int first = heads[slot];
+    heads[slot] = -1;
+    return first;
+}
+
+void active_item_cache::schedule( const int id )
+{
+    node &n = nodes[id];
+    n.due = std::max( n.due, current_turn );
+    const int delta = n.due - current_turn;
+    if( delta < wheel_size ) {
+        link( id, n.due & ( wheel_size - 1 ) );
+    } else if( delta < wheel_size * wheel_size ) {
+        link( id, wheel_size + ( ( n.due >> wheel_bits ) & ( wheel_size - 1 ) ) );
+    } else {
+        link( id, overflow_slot );
+    }
+}
+
+void active_item_cache::release( const int id )
+{
+    node &n = nodes[id];
+    const auto found = index.find( n.key );
+    if( found != index.end() && found->second == id ) {
+        index.erase( found );
+    }
+    n = node();
+    free_nodes.push_back( id );
+}
+
+void active_item_cache::processed( const int id, const int now,
+                                   std::vector<item_reference> &items )
+{
+    node &n = nodes[id];
+    if( !n.ref.item_ref ) {
+        // The item has been destroyed, so remove the reference from the cache
+        release( id );
+        return;
+    }
+    items.push_back( n.ref );
+    n.due = now + n.speed;
+    schedule( id );
+}
+
+void active_item_cache::reschedule( const int slot )
+{
+    for( int id = take( slot ); id >= 0; ) {
+        const int next = nodes[id].next;
+        schedule( id );
+        id = next;
+    }
+}
+
+void active_item_cache::collect_turn( const int turn, std::vector<item_reference> &items )
+{
+    if( ( turn & ( wheel_size - 1 ) ) == 0 ) {
+        // A new block of turns starts, spread its items over the slots of single turns.
+        const int block = ( turn >> wheel_bits ) & ( wheel_size - 1 );
+        if( block == 0 ) {
+            reschedule( overflow_slot );
+        }
+        reschedule( wheel_size + block );
+    }
+    const int now = turn_now();
+    for( int id = take( turn & ( wheel_size - 1 ) ); id >= 0; ) {
+        const int next = nodes[id].next;
+        processed( id, now, items );
+        id = next;
+    }
+}
+
+void active_item_cache::collect_all( const int now, std::vector<item_reference> &items )
+{
+    std::vector<int> all;
+    for( int slot = 0; slot <= overflow_slot; ++slot ) {
+        for( int id = take( slot ); id >= 0; id = nodes[id].next ) {
+            all.push_back( id );
+        }
+    }
+    for( const int id : all ) {
+        processed( id, now, items );
+    }
+}
+
 bool active_item_cache::add( item &it, point_sm_ms location, item *parent,
                              std::vector<item_pocket const *> const &pocket_chain )
 {
@@ -47,24 +171,17 @@ bool active_item_cache::add( item &it, point_rel_ms location, item *parent,
     if( speed == item::NO_PROCESSING ) {
         return ret;
     }
-    std::unordered_map<item *, safe_reference<item>> &target_index = active_items_index[speed];
-    std::list<item_reference> &target_list = active_items[speed];
-    if( target_index.empty() && !target_index.empty() ) {
-        // If the index has been cleared, rebuild it first.
-        for( item_reference &iter : target_list ) {
-            // Omit those expired references
-            if( iter.item_ref ) {
-                target_index.emplace( iter.item_ref.get(), iter.item_ref );
-            }
-        }
-    }
     // If the item is already in the cache for some reason, don't add a second reference
-    auto iter = target_index.find( &it );
-    if( iter != target_index.end() ) {
+    const auto iter = index.find( &it );
+    if( iter != index.end() ) {
         // Ensure it's really what we want, and hasn't expired
-        if( iter->second && iter->second.get() == &it ) {
+        const node &n = nodes[iter->second];
+        if( n.ref.item_ref && n.ref.item_ref.get() == &it ) {
             return true;
         }
+        // Another item that used to live at the same address.
+        unlink( iter->second );
+        release( iter->second );
     }
     item_reference ref{ location, it.get_safe_reference(), parent, pocket_chain };
     if( it.can_revive() ) {
@@ -73,30 +190,49 @@ bool active_item_cache::add( item &it, point_rel_ms location, item *parent,
     if( it.get_use( "explosion" ) ) {
         special_items[special_item_type::explosive].emplace_back( ref );
     }
-    target_list.emplace_back( std::move( ref ) );
-    target_index.emplace( &it, it.get_safe_reference() );
+
+    const int now = turn_now();
+    if( index.empty() ) {
+        current_turn = now;
+    }
+    int id;
+    if( free_nodes.empty() ) {
+        id = static_cast<int>( nodes.size() );
+        nodes.emplace_back();
+    } else {
+        id = free_nodes.back();
+        free_nodes.pop_back();
+    }
+    node &n = nodes[id];
+    n.ref = std::move( ref );
+    n.key = &it;
+    n.speed = speed;
+    // Spread out when slow items are first processed, so that those added together are not
+    // all processed on the same turn ever after.
+    n.due = now + static_cast<int>( added++ % static_cast<unsigned int>( speed ) );
+    schedule( id );
+    index.emplace( &it, id );
     return true;
 }
 
 bool active_item_cache::empty() const
 {
-    return std::all_of( active_items.begin(), active_items.end(), []( const auto & active_queue ) {
-        return active_queue.second.empty();
-    } );
+    return index.empty();
 }
 
 std::vector<item_reference> active_item_cache::get()
 {
     std::vector<item_reference> all_cached_items;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        for( std::list<item_reference>::iterator it = kv.second.begin(); it != kv.second.end(); ) {
-            if( it->item_ref ) {
-                all_cached_items.emplace_back( *it );
-                ++it;
-            } else {
-                active_items_index[kv.first].clear();
-                it = kv.second.erase( it );
-            }
+    for( int id = 0; id < static_cast<int>( nodes.size() ); ++id ) {
+        node &n = nodes[id];
+        if( n.slot < 0 ) {
+            continue;
+        }
+        if( n.ref.item_ref ) {
+            all_cached_items.emplace_back( n.ref );
+        } else {
+            unlink( id );
+            release( id );
         }
     }
     return all_cached_items;
@@ -105,32 +241,38 @@ std::vector<item_reference> active_item_cache::get()
 std::vector<item_reference> active_item_cache::get_for_processing()
 {
     std::vector<item_reference> items_to_process;
-    items_to_process.reserve( std::accumulate( active_items.begin(), active_items.end(), std::size_t{ 0 },
-    []( size_t prev, const auto & kv ) {
-        return prev + kv.second.size() / static_cast<size_t>( kv.first );
-    } ) );
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        // Rely on iteration logic to make sure the number is sane.
-        int num_to_process = kv.second.size() / kv.first;
-        std::list<item_reference>::iterator it = kv.second.begin();
-        for( ; it != kv.second.end() && num_to_process >= 0; ) {
-            if( it->item_ref ) {
-                items_to_process.push_back( *it );
-                --num_to_process;
-                ++it;
-            } else {
-                // The item has been destroyed, so remove the reference from the cache
-                active_items_index[kv.first].clear();
-                it = kv.second.erase( it );
-            }
-        }
-        // Rotate the returned items to the end of their list so that the items that weren't
-        // returned this time will be first in line on the next call
-        kv.second.splice( kv.second.end(), kv.second, kv.second.begin(), it );
+    if( index.empty() ) {
+        return items_to_process;
+    }
+    const int now = turn_now();
+    if( now < current_turn - 1 || now - current_turn >= wheel_size * wheel_size ) {
+        // Time was moved back, or so far ahead that everything is due.
+        current_turn = now + 1;
+        collect_all( now, items_to_process );
+        return items_to_process;
+    }
+    for( ; current_turn <= now; ++current_turn ) {
+        collect_turn( current_turn, items_to_process );
     }
     return items_to_process;
 }
 
+void active_item_cache::postpone( const item &it, const time_point &until )
+{
+    const auto found = index.find( &it );
+    if( found == index.end() ) {
+        return;
+    }
+    node &n = nodes[found->second];
+    const int due = to_turns<int>( until - calendar::turn_zero );
+    if( n.slot < 0 || due <= n.due ) {
+        return;
+    }
+    unlink( found->second );
+    n.due = due;
+    schedule( found->second );
+}
+
 std::vector<item_reference> active_item_cache::get_special( special_item_type type )
 {
     std::vector<item_reference> matching_items;
@@ -148,32 +290,26 @@ std::vector<item_reference> active_item_cache::get_special( special_item_type ty
 
 void active_item_cache::subtract_locations( const point_rel_ms &delta )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location -= delta;
-        }
-    }
+    for_each_node( [&delta]( node & n ) {
+        n.ref.location -= delta;
+    } );
 }
 
 void active_item_cache::rotate_locations( int turns, const point_rel_ms &dim )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            // Should 'rotate' be propaged up to the typed coordinates?
-            ir.location = ir.location.rotate( turns, dim.raw() );
-        }
-    }
+    for_each_node( [turns, &dim]( node & n ) {
+        // Should 'rotate' be propaged up to the typed coordinates?
+        n.ref.location = n.ref.location.rotate( turns, dim.raw() );
+    } );
 }
 
 void active_item_cache::mirror( const point_rel_ms &dim, bool horizontally )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            if( horizontally ) {
-                ir.location.x() = dim.x() - 1 - ir.location.x();
-            } else {
-                ir.location.y() = dim.y() - 1 - ir.location.y();
-            }
+    for_each_node( [&dim, horizontally]( node & n ) {
+        if( horizontally ) {
+            n.ref.location.x() = dim.x() - 1 - n.ref.location.x();
+        } else {
+            n.ref.location.y() = dim.y() - 1 - n.ref.location.y();
         }
-    }
+    } );
 }
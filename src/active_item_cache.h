@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_ACTIVE_ITEM_CACHE_H
 #define CATA_SRC_ACTIVE_ITEM_CACHE_H
 
+#include <array>
 #include <cstddef>
 #include <list>
 #include <unordered_map>
@@ -12,6 +13,7 @@
 
 class item;
 class item_pocket;
+class time_point;
 
 // A struct used to uniquely identify an item within a submap or vehicle.
 struct item_reference {
@@ -48,13 +50,77 @@ struct hash<special_item_type> {
 };
 } // namespace std
 
+/**
+ * The active items of a submap or vehicle, scheduled on a hierarchical timing wheel so that
+ * each turn only the items that are due are looked at.
+ *
+ * An item is due every item::processing_speed() turns.  The wheel has a slot for each of the
+ * next wheel_size turns, and a coarser slot for each of the wheel_size blocks of wheel_size
+ * turns after that; items due later still wait in an overflow list.  The coarse slots are
+ * moved down into the fine ones as their block comes up.
+ * Items are kept in a vector of nodes that hold the links of their slot's list, so
+ * rescheduling an item never allocates.
+ */
 class active_item_cache
 {
     private:
-        std::unordered_map<int, std::list<item_reference>> active_items;
+        static constexpr int wheel_bits = 6;
+        static constexpr int wheel_size = 1 << wheel_bits;
+        static constexpr int overflow_slot = wheel_size * 2;
+
+        struct node {
+            item_reference ref;
+            // Only used to find the node in index, ref might already be broken.
+            const item *key = nullptr;
+            int speed = 0;
+            // Turn the item is next processed on.
+            int due = 0;
+            // The slot the node is listed in, or -1 if the node is unused, and its neighbors
+            // in that list.
+            int slot = -1;
+            int prev = -1;
+            int next = -1;
+        };
+
+        std::vector<node> nodes;
+        std::vector<int> free_nodes;
+        // First node of each slot: wheel_size turns, then wheel_size blocks, then overflow.
+        std::array<int, overflow_slot + 1> heads;
+        // The next turn the wheel has to look at.
+        int current_turn = 0;
+        // Counts the added items, to spread out when slow items are first due.
+        unsigned int added = 0;
+        std::unordered_map<const item *, int> index;
         std::unordered_map<special_item_type, std::list<item_reference>> special_items;
-        std::unordered_map<int, std::unordered_map<item *, safe_reference<item>>> active_items_index;
+
+        static int turn_now();
+        void link( int id, int slot );
+        void unlink( int id );
+        /** Detaches and returns the list of slot. */
+        int take( int slot );
+        /** Puts the node into the slot its due turn falls into. */
+        void schedule( int id );
+        /** Schedules the nodes of slot again, e.g. when its block of turns comes up. */
+        void reschedule( int slot );
+        void release( int id );
+        /** Takes the due nodes of turn, which must be current_turn, into items. */
+        void collect_turn( int turn, std::vector<item_reference> &items );
+        /** Takes every node into items, for when time jumped past the end of the wheel. */
+        void collect_all( int now, std::vector<item_reference> &items );
+        /** Reschedules a node that was just taken, or releases it if its item is gone. */
+        void processed( int id, int now, std::vector<item_reference> &items );
+
+        template<typename F>
+        void for_each_node( F &&func ) {
+            for( node &n : nodes ) {
+                if( n.slot >= 0 ) {
+                    func( n );
+                }
+            }
+        }
     public:
+        active_item_cache();
+
         /**
          * Adds the reference to the cache. Does nothing if the reference is already in the cache.
          * Relies on the fact that item::processing_speed() is a constant.
@@ -67,7 +133,8 @@ class active_item_cache
                   std::vector<item_pocket const *> const &pocket_chain = {} );
 
         /**
-         * Returns true if the cache is empty
+         * Returns true if the cache holds no item.  References to items that are gone count
+         * until get() or get_for_processing() drops them.
          */
         bool empty() const;
 
@@ -78,15 +145,22 @@ class active_item_cache
         std::vector<item_reference> get();
 
         /**
-         * Returns the first size() / processing_speed() elements of each list, rounded up.
-         * Items returned are rotated to the back of their respective lists, otherwise only the
-         * first n items will ever be processed.
+         * Returns the items that are due to be processed on the current turn, and schedules
+         * them again item::processing_speed() turns later.  Items added to the cache are first
+         * due within that many turns.  If more than one turn passed since the last call, the
+         * items that came due in between are returned as well, but each only once.
          * Broken references encountered when collecting the items to be processed are removed from
          * the cache.
          * Relies on the fact that item::processing_speed() is a constant.
          */
         std::vector<item_reference> get_for_processing();
 
+        /**
+         * Makes the item due no earlier than the given time, e.g. when it was just processed and
+         * nothing happens to it until then.  Does nothing if the item is not in the cache.
+         */
+        void postpone( const item &it, const time_point &until );
+
         /**
          * Returns the currently tracked list of special active items.
          */
@@ -934,6 +934,18 @@ mfaction_id avatar::get_monster_faction() const
     return monfaction_player.id();
 }
 
+path_avoid_mask avatar::get_path_avoid_mask() const
+{
+    // Matches Character::get_path_avoid(): stay clear of the NPCs we can see.
+    path_avoid_mask mask;
+    for( const npc &guy : g->all_npcs() ) {
+        if( sees( guy ) ) {
+            mask.set( guy.pos_bub() );
+        }
+    }
+    return mask;
+}
+
 void avatar::reset_stats()
 {
     const int current_stim = get_stim();
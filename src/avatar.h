@@ -42,6 +42,7 @@ class mission;
 class monster;
 class nc_color;
 class npc;
+class path_avoid_mask;
 class talker;
 struct bionic;
 struct mtype;
@@ -120,6 +121,12 @@ class avatar : public Character
 
         mfaction_id get_monster_faction() const override;
 
+        /**
+         * The points get_path_avoid() avoids, for routing several times in a row before
+         * anything moves, e.g. to pick the first reachable of a few destinations.
+         */
+        path_avoid_mask get_path_avoid_mask() const;
+
         void witness_thievery( item * ) override {}
 
         std::string get_save_id() const {
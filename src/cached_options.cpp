@@ -18,6 +18,9 @@ bool use_pinyin_search;
 bool use_tiles_overmap;
 test_mode_spilling_action_t test_mode_spilling_action = test_mode_spilling_action_t::spill_all;
 bool direct3d_mode;
+int worker_threads;
+bool data_snapshots;
+bool gas_spread_grid;
 bool pixel_minimap_option;
 int pixel_minimap_r;
 int pixel_minimap_g;
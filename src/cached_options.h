@@ -25,6 +25,9 @@ extern bool use_tiles;
 extern bool use_far_tiles;
 extern bool use_pinyin_search;
 extern bool use_tiles_overmap;
+extern int worker_threads;
+extern bool data_snapshots;
+extern bool gas_spread_grid;
 extern bool pixel_minimap_option;
 extern int pixel_minimap_r;
 extern int pixel_minimap_g;
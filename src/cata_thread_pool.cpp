@@ -0,0 +1,262 @@
+#include "cata_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cached_options.h"
+#include "cata_scope_helpers.h"
+
+static thread_local bool running_parallel_task = false;
+
+static void run_as_parallel_task( const std::function<void()> &task )
+{
+    const bool was_running = running_parallel_task;
+    running_parallel_task = true;
+    on_out_of_scope reset_flag( [was_running]() {
+        running_parallel_task = was_running;
+    } );
+    task();
+}
+
+namespace
+{
+
+class worker_pool
+{
+    public:
+        worker_pool() = default;
+        worker_pool( const worker_pool & ) = delete;
+        worker_pool &operator=( const worker_pool & ) = delete;
+
+        ~worker_pool() {
+            {
+                std::lock_guard<std::mutex> lk( mutex );
+                stopping = true;
+            }
+            work_cv.notify_all();
+            for( std::thread &t : threads ) {
+                t.join();
+            }
+        }
+
+        void push( std::function<void()> task, size_t num_workers ) {
+            {
+                std::lock_guard<std::mutex> lk( mutex );
+                while( threads.size() < num_workers ) {
+                    const size_t index = threads.size();
+                    threads.emplace_back( [this, index]() {
+                        worker_loop( index );
+                    } );
+                }
+                active_workers = num_workers;
+                tasks.push_back( std::move( task ) );
+            }
+            work_cv.notify_all();
+        }
+
+        /** Runs one queued task on the calling thread, returns false if there was none. */
+        bool help() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lk( mutex );
+                if( tasks.empty() ) {
+                    return false;
+                }
+                task = std::move( tasks.front() );
+                tasks.pop_front();
+            }
+            run_as_parallel_task( task );
+            return true;
+        }
+
+    private:
+        void worker_loop( size_t index ) {
+            while( true ) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lk( mutex );
+                    work_cv.wait( lk, [&]() {
+                        // Workers beyond the requested thread count stay idle.
+                        return stopping || ( index < active_workers && !tasks.empty() );
+                    } );
+                    if( stopping ) {
+                        return;
+                    }
+                    task = std::move( tasks.front() );
+                    tasks.pop_front();
+                }
+                run_as_parallel_task( task );
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable work_cv;
+        std::vector<std::thread> threads;
+        std::deque<std::function<void()>> tasks;
+        size_t active_workers = 0;
+        bool stopping = false;
+};
+
+} // namespace
+
+static worker_pool &get_worker_pool()
+{
+    static worker_pool pool;
+    return pool;
+}
+
+namespace cata
+{
+
+int parallel_thread_count()
+{
+#if defined(EMSCRIPTEN)
+    return 1;
+#else
+    if( worker_threads > 0 ) {
+        return worker_threads;
+    }
+    return std::max( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+#endif
+}
+
+bool in_parallel_task()
+{
+    return running_parallel_task;
+}
+
+struct task_group::shared_state {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    size_t pending = 0;
+    std::vector<std::exception_ptr> errors;
+};
+
+task_group::task_group() : state( std::make_shared<shared_state>() ) {}
+
+task_group::~task_group()
+{
+    // Tasks reference the caller's data, so they must not outlive the group.
+    try {
+        wait();
+    } catch( ... ) {
+        // Errors are only reported through wait().
+    }
+}
+
+void task_group::run( std::function<void()> task )
+{
+    const int num_threads = parallel_thread_count();
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lk( state->mutex );
+        index = state->errors.size();
+        state->errors.emplace_back();
+        if( num_threads > 1 ) {
+            ++state->pending;
+        }
+    }
+    if( num_threads <= 1 ) {
+        try {
+            run_as_parallel_task( task );
+        } catch( ... ) {
+            std::lock_guard<std::mutex> lk( state->mutex );
+            state->errors[index] = std::current_exception();
+        }
+        return;
+    }
+    std::shared_ptr<shared_state> st = state;
+    get_worker_pool().push( [st, index, task = std::move( task )]() {
+        std::exception_ptr error;
+        try {
+            task();
+        } catch( ... ) {
+            error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lk( st->mutex );
+            st->errors[index] = error;
+            --st->pending;
+        }
+        st->done_cv.notify_all();
+    }, num_threads - 1 );
+}
+
+void task_group::wait()
+{
+    while( true ) {
+        {
+            std::lock_guard<std::mutex> lk( state->mutex );
+            if( state->pending == 0 ) {
+                break;
+            }
+        }
+        // Rather than idling, work through the queue; this also keeps nested
+        // groups from waiting on tasks that no worker is free to pick up.
+        if( !get_worker_pool().help() ) {
+            std::unique_lock<std::mutex> lk( state->mutex );
+            state->done_cv.wait( lk, [this]() {
+                return state->pending == 0;
+            } );
+            break;
+        }
+    }
+
+    std::vector<std::exception_ptr> errors;
+    {
+        std::lock_guard<std::mutex> lk( state->mutex );
+        errors.swap( state->errors );
+    }
+    for( const std::exception_ptr &e : errors ) {
+        if( e ) {
+            std::rethrow_exception( e );
+        }
+    }
+}
+
+void parallel_for( size_t count, const std::function<void( size_t )> &func )
+{
+    const size_t num_threads = std::min( count,
+                                         static_cast<size_t>( parallel_thread_count() ) );
+    if( num_threads <= 1 || running_parallel_task ) {
+        for( size_t i = 0; i < count; ++i ) {
+            func( i );
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_index{ 0 };
+    std::vector<std::exception_ptr> errors( count );
+    const auto process = [&]() {
+        for( size_t i = next_index++; i < count; i = next_index++ ) {
+            try {
+                func( i );
+            } catch( ... ) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    {
+        task_group helpers;
+        for( size_t t = 1; t < num_threads; ++t ) {
+            helpers.run( process );
+        }
+        run_as_parallel_task( process );
+        helpers.wait();
+    }
+    for( const std::exception_ptr &e : errors ) {
+        if( e ) {
+            std::rethrow_exception( e );
+        }
+    }
+}
+
+} // namespace cata
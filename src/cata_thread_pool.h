@@ -0,0 +1,65 @@
+#pragma once
+#ifndef CATA_SRC_CATA_THREAD_POOL_H
+#define CATA_SRC_CATA_THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace cata
+{
+
+/**
+ * Number of threads, including the calling one, that parallel_for spreads its
+ * work over.  Controlled by the WORKER_THREADS option; 0 means one per core.
+ */
+int parallel_thread_count();
+
+/** True while the current thread is executing a parallel_for task. */
+bool in_parallel_task();
+
+/**
+ * Calls func( i ) once for every i in [0, count), spreading the calls over a
+ * persistent pool of worker threads.  The calling thread takes part in the work
+ * and the function only returns once every call has finished.
+ *
+ * The order in which the calls run is unspecified, so func must only write to
+ * state owned by index i.  Nested calls, and calls when only one thread is
+ * available, simply run the loop on the calling thread.
+ *
+ * If calls throw, the exception thrown by the lowest index is rethrown once the
+ * work has stopped.  Calls that had not started yet may be skipped.
+ */
+void parallel_for( size_t count, const std::function<void( size_t )> &func );
+
+/**
+ * A set of tasks handed to the worker pool.  Unlike parallel_for the caller is
+ * free to do other work while the tasks run, and only blocks in wait().
+ *
+ * With a single thread available, run() executes the task immediately.
+ */
+class task_group
+{
+    public:
+        task_group();
+        task_group( const task_group & ) = delete;
+        task_group &operator=( const task_group & ) = delete;
+        /** Waits for the tasks still running, discarding their errors. */
+        ~task_group();
+
+        void run( std::function<void()> task );
+        /**
+         * Blocks until every task handed to run() has finished, helping with
+         * queued work meanwhile.  If tasks threw, rethrows the exception of the
+         * one that was started first.
+         */
+        void wait();
+
+    private:
+        struct shared_state;
+        std::shared_ptr<shared_state> state;
+};
+
+} // namespace cata
+
+#endif // CATA_SRC_CATA_THREAD_POOL_H
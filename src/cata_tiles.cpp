@@ -238,6 +238,7 @@ cata_tiles::~cata_tiles() = default;
 
 void cata_tiles::on_options_changed()
 {
+    last_frame.valid = false;
     memory_map_mode = get_option <std::string>( "MEMORY_MAP_MODE" );
 
     pixel_minimap_settings settings;
@@ -335,6 +336,13 @@ tile_type &tileset::create_tile_type( const std::string &id, tile_type &&new_til
 void cata_tiles::load_tileset( const std::string &tileset_id, const bool precheck,
                                const bool force, const bool pump_events, const bool terrain )
 {
+    // Also cleared when the tileset is kept, as this is how we learn that the data was reloaded.
+    for( std::array<std::vector<resolved_tile>, NUM_SEASONS> &category : resolved_tiles ) {
+        for( std::vector<resolved_tile> &season : category ) {
+            season.clear();
+        }
+    }
+    last_frame.valid = false;
     if( tileset_ptr && tileset_ptr->get_tileset_id() == tileset_id && !force ) {
         return;
     }
@@ -1321,15 +1329,13 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     }
 #endif
 
-    {
-        //set clipping to prevent drawing over stuff we shouldn't
-        SDL_Rect clipRect = {dest.x, dest.y, width, height};
-        printErrorIf( SDL_RenderSetClipRect( renderer.get(), &clipRect ) != 0,
-                      "SDL_RenderSetClipRect failed" );
+    //set clipping to prevent drawing over stuff we shouldn't
+    const SDL_Rect clip_rect = {dest.x, dest.y, width, height};
+    printErrorIf( SDL_RenderSetClipRect( renderer.get(), &clip_rect ) != 0,
+                  "SDL_RenderSetClipRect failed" );
 
-        //fill render area with black to prevent artifacts where no new pixels are drawn
-        geometry->rect( renderer, clipRect, SDL_Color() );
-    }
+    //fill render area with black to prevent artifacts where no new pixels are drawn
+    geometry->rect( renderer, clip_rect, SDL_Color() );
 
     const point s = get_window_base_tile_counts( point( width, height ) );
 
@@ -1420,6 +1426,34 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     here.prev_bottom_right = bottom_right;
     here.prev_o = o;
 
+    in_animation = do_draw_explosion || do_draw_custom_explosion ||
+                   do_draw_bullet || do_draw_hit || do_draw_line ||
+                   do_draw_cursor || do_draw_highlight || do_draw_weather ||
+                   do_draw_sct || do_draw_zones || do_draw_async_anim;
+
+    // If nothing that went into the last frame has changed, the map would be drawn exactly as
+    // it was, so copy it back instead. Anything changing the map in between either takes time,
+    // or marks the draw cache dirty.
+    if( last_frame.valid && !here.draw_points_cache_dirty && !in_animation &&
+        !drew_animated_tile && !has_any_draw_override() &&
+        last_frame.dest == dest && last_frame.center == center &&
+        last_frame.size == point( width, height ) &&
+        last_frame.tile_size == point( tile_width, tile_height ) &&
+        last_frame.tiles == tileset_ptr.get() && last_frame.turn == calendar::turn &&
+        last_frame.moves == you.get_moves() && last_frame.overlay == g->displaying_overlays &&
+        last_frame.visibility_creature == g->displaying_visibility_creature &&
+        last_frame.lighting_condition == g->displaying_lighting_condition ) {
+        RenderCopy( renderer, last_frame.texture, nullptr, &clip_rect );
+        overlay_strings = here.overlay_strings_cache;
+        color_blocks = here.color_blocks_cache;
+        draw_animations_and_cursors( center, overlay_strings );
+        printErrorIf( SDL_RenderSetClipRect( renderer.get(), nullptr ) != 0,
+                      "SDL_RenderSetClipRect failed" );
+        return;
+    }
+    last_frame.valid = false;
+    drew_animated_tile = false;
+
     you.prepare_map_memory_region(
         here.getglobal( tripoint_bub_ms( min_mm_reg.x, min_mm_reg.y, center.z ) ),
         here.getglobal( tripoint_bub_ms( max_mm_reg.x, max_mm_reg.y, center.z ) )
@@ -1844,6 +1878,7 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
         }
     }
     // tile overrides are already drawn in the previous code
+    const bool overridden = has_any_draw_override();
     void_radiation_override();
     void_terrain_override();
     void_furniture_override();
@@ -1891,11 +1926,30 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
         }
     }
 
-    in_animation = do_draw_explosion || do_draw_custom_explosion ||
-                   do_draw_bullet || do_draw_hit || do_draw_line ||
-                   do_draw_cursor || do_draw_highlight || do_draw_weather ||
-                   do_draw_sct || do_draw_zones || do_draw_async_anim;
+    if( !overridden ) {
+        last_frame.dest = dest;
+        last_frame.center = center;
+        last_frame.size = point( width, height );
+        last_frame.tile_size = point( tile_width, tile_height );
+        last_frame.tiles = tileset_ptr.get();
+        last_frame.turn = calendar::turn;
+        last_frame.moves = you.get_moves();
+        last_frame.overlay = g->displaying_overlays;
+        last_frame.visibility_creature = g->displaying_visibility_creature;
+        last_frame.lighting_condition = g->displaying_lighting_condition;
+        retain_frame( clip_rect );
+    }
 
+    draw_animations_and_cursors( center, overlay_strings );
+
+    printErrorIf( SDL_RenderSetClipRect( renderer.get(), nullptr ) != 0,
+                  "SDL_RenderSetClipRect failed" );
+}
+
+void cata_tiles::draw_animations_and_cursors( const tripoint &center,
+        std::multimap<point, formatted_text> &overlay_strings )
+{
+    avatar &you = get_avatar();
     draw_footsteps_frame( center );
     if( in_animation ) {
         if( do_draw_explosion ) {
@@ -1953,9 +2007,44 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                                  0, 0, lit_level::LIT, false );
         }
     }
+}
 
-    printErrorIf( SDL_RenderSetClipRect( renderer.get(), nullptr ) != 0,
+void cata_tiles::retain_frame( const SDL_Rect &area )
+{
+    last_frame.valid = false;
+    SDL_Texture *const target = SDL_GetRenderTarget( renderer.get() );
+    if( target == nullptr || !SDL_RenderTargetSupported( renderer.get() ) ) {
+        return;
+    }
+    int texture_width = 0;
+    int texture_height = 0;
+    if( last_frame.texture ) {
+        SDL_QueryTexture( last_frame.texture.get(), nullptr, nullptr, &texture_width,
+                          &texture_height );
+    }
+    if( texture_width != area.w || texture_height != area.h ) {
+        last_frame.texture = CreateTexture( renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_TARGET, area.w, area.h );
+        if( !last_frame.texture ) {
+            return;
+        }
+        SDL_SetTextureBlendMode( last_frame.texture.get(), SDL_BLENDMODE_NONE );
+    }
+    // Copy the pixels unchanged, including their alpha, so that copying them back gives exactly
+    // what was drawn.
+    SDL_BlendMode target_blend_mode = SDL_BLENDMODE_NONE;
+    SDL_GetTextureBlendMode( target, &target_blend_mode );
+    SDL_SetTextureBlendMode( target, SDL_BLENDMODE_NONE );
+    SetRenderTarget( renderer, last_frame.texture );
+    const bool copied = !printErrorIf( SDL_RenderCopy( renderer.get(), target, &area, nullptr ) != 0,
+                                       "SDL_RenderCopy failed" );
+    printErrorIf( SDL_SetRenderTarget( renderer.get(), target ) != 0,
+                  "SDL_SetRenderTarget failed" );
+    SDL_SetTextureBlendMode( target, target_blend_mode );
+    // Changing the render target resets the clip rect.
+    printErrorIf( SDL_RenderSetClipRect( renderer.get(), &area ) != 0,
                   "SDL_RenderSetClipRect failed" );
+    last_frame.valid = copied;
 }
 
 void cata_tiles::set_draw_cache_dirty()
@@ -2292,6 +2381,14 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
             ll, -1, apply_night_vision_goggles, height_3d, intensity_level,
             variant, offset );
 }
+bool cata_tiles::draw_from_id_string( const std::string &id, const resolved_tile &resolved,
+                                      TILE_CATEGORY category, const tripoint &pos, int subtile,
+                                      int rota, lit_level ll, bool apply_night_vision_goggles,
+                                      int &height_3d )
+{
+    return cata_tiles::draw_from_id_string_internal( id, category, empty_string, pos, subtile, rota,
+            ll, -1, apply_night_vision_goggles, height_3d, 0, "", point(), &resolved );
+}
 bool cata_tiles::draw_from_id_string_internal( const std::string &id, const tripoint &pos,
         int subtile,
         int rota,
@@ -2309,6 +2406,30 @@ cata_tiles::find_tile_with_season( const std::string &id ) const
     return tileset_ptr->find_tile_type_by_season( id, season );
 }
 
+const resolved_tile &cata_tiles::resolve_tile( TILE_CATEGORY category, const int index,
+        const std::string &id )
+{
+    const season_type season = season_of_year( calendar::turn );
+    std::vector<resolved_tile> &tiles = resolved_tiles[static_cast<size_t>( category )][season];
+    if( static_cast<size_t>( index ) >= tiles.size() ) {
+        tiles.resize( index + 1 );
+    }
+    resolved_tile &ret = tiles[index];
+    if( !ret.resolved ) {
+        ret.tile = find_tile_looks_like( id, category, "" );
+        if( ret.tile ) {
+            // Same lookups as for drawing a subtile of a multitile in draw_from_id_string_internal
+            const std::string found_id = ret.tile->id() + "_";
+            for( size_t i = 0; i < multitile_keys.size(); ++i ) {
+                ret.subtiles[i] = find_tile_looks_like( found_id + multitile_keys[i], category,
+                                                        "" );
+            }
+        }
+        ret.resolved = true;
+    }
+    return ret;
+}
+
 template<typename T>
 std::optional<tile_lookup_res>
 cata_tiles::find_tile_looks_like_by_string_id( const std::string_view id, TILE_CATEGORY category,
@@ -2536,7 +2657,7 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
         int subtile, int rota, lit_level ll, int retract,
         bool apply_night_vision_goggles, int &height_3d,
         int intensity_level, const std::string &variant,
-        const point &offset )
+        const point &offset, const resolved_tile *resolved )
 {
     bool nv_color_active = apply_night_vision_goggles && get_option<bool>( "NV_GREEN_TOGGLE" );
     // If the ID string does not produce a drawable tile
@@ -2589,7 +2710,7 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
     }
     // if a tile with intensity hasn't already been found then fall back to a base tile
     if( !res ) {
-        res = find_tile_looks_like( id, category, variant );
+        res = resolved ? resolved->tile : find_tile_looks_like( id, category, variant );
         if( res ) {
             tt = &res -> tile();
         }
@@ -2822,6 +2943,16 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
         const auto end = std::end( display_subtiles );
         if( std::find( begin( display_subtiles ), end, multitile_keys[subtile] ) != end ) {
             // append subtile name to tile and re-find display_tile
+            if( resolved && resolved->subtiles[subtile] ) {
+                resolved_tile resolved_subtile;
+                resolved_subtile.resolved = true;
+                resolved_subtile.tile = resolved->subtiles[subtile];
+                // The id is only needed for the fallbacks when there is no tile, so the one the
+                // subtile was found under does as well as building the name again.
+                return draw_from_id_string_internal(
+                           resolved_subtile.tile->id(), category, subcategory, pos, -1, rota, ll,
+                           retract, nv_color_active, height_3d, 0, "", point(), &resolved_subtile );
+            }
             return draw_from_id_string_internal(
                        found_id + "_" + multitile_keys[subtile], category, subcategory, pos, -1, rota, ll,
                        retract, nv_color_active, height_3d, 0, "", point() );
@@ -2953,6 +3084,7 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
 
         // idle tile animations:
         if( display_tile.animated ) {
+            drew_animated_tile = true;
             // idle animations run during the user's turn, and the animation speed
             // needs to be defined by the tileset to look good, so we use system clock:
             std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
@@ -3360,8 +3492,10 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         if( !neighborhood_overridden ) {
             return memorize_only
                    ? false
-                   : draw_from_id_string( tname, TILE_CATEGORY::TERRAIN, empty_string, p, subtile,
-                                          rotation, ll, nv_goggles_activated, height_3d );
+                   : draw_from_id_string( tname,
+                                          resolve_tile( TILE_CATEGORY::TERRAIN, t.to_i(), tname ),
+                                          TILE_CATEGORY::TERRAIN, p, subtile, rotation, ll,
+                                          nv_goggles_activated, height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -3389,8 +3523,10 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
             const bool nv = overridden ? false : nv_goggles_activated;
             return memorize_only
                    ? false
-                   : draw_from_id_string( tname, TILE_CATEGORY::TERRAIN, empty_string, p, subtile,
-                                          rotation, lit, nv, height_3d );
+                   : draw_from_id_string( tname,
+                                          resolve_tile( TILE_CATEGORY::TERRAIN, t2.to_i(), tname ),
+                                          TILE_CATEGORY::TERRAIN, p, subtile, rotation, lit, nv,
+                                          height_3d );
         }
     } else if( invisible[0] ) {
         // try drawing memory if invisible and not overridden
@@ -3451,8 +3587,10 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
         if( !neighborhood_overridden ) {
             return memorize_only
                    ? false
-                   : draw_from_id_string( fname, TILE_CATEGORY::FURNITURE, empty_string, p, subtile,
-                                          rotation, ll, nv_goggles_activated, height_3d );
+                   : draw_from_id_string( fname,
+                                          resolve_tile( TILE_CATEGORY::FURNITURE, f.to_i(), fname ),
+                                          TILE_CATEGORY::FURNITURE, p, subtile, rotation, ll,
+                                          nv_goggles_activated, height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -3490,8 +3628,11 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
             const bool nv = overridden ? false : nv_goggles_activated;
             return memorize_only
                    ? false
-                   : draw_from_id_string( fname, TILE_CATEGORY::FURNITURE, empty_string, p, subtile,
-                                          rotation, lit, nv, height_3d );
+                   : draw_from_id_string( fname,
+                                          resolve_tile( TILE_CATEGORY::FURNITURE, f2.to_i(),
+                                                  fname ),
+                                          TILE_CATEGORY::FURNITURE, p, subtile, rotation, lit, nv,
+                                          height_3d );
         }
     } else if( invisible[0] ) {
         // try drawing memory if invisible and not overridden
@@ -3544,8 +3685,11 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
         if( !neighborhood_overridden ) {
             return memorize_only
                    ? false
-                   : draw_from_id_string( trname, TILE_CATEGORY::TRAP, empty_string, p, subtile,
-                                          rotation, ll, nv_goggles_activated, height_3d );
+                   : draw_from_id_string( trname,
+                                          resolve_tile( TILE_CATEGORY::TRAP, tr.loadid.to_i(),
+                                                  trname ),
+                                          TILE_CATEGORY::TRAP, p, subtile, rotation, ll,
+                                          nv_goggles_activated, height_3d );
         }
     }
     if( overridden || ( !invisible[0] && neighborhood_overridden &&
@@ -3576,8 +3720,10 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
             const bool nv = overridden ? false : nv_goggles_activated;
             return memorize_only
                    ? false
-                   : draw_from_id_string( trname, TILE_CATEGORY::TRAP, empty_string, p, subtile,
-                                          rotation, lit, nv, height_3d );
+                   : draw_from_id_string( trname,
+                                          resolve_tile( TILE_CATEGORY::TRAP, tr2.to_i(), trname ),
+                                          TILE_CATEGORY::TRAP, p, subtile, rotation, lit, nv,
+                                          height_3d );
         }
     } else if( invisible[0] ) {
         // try drawing memory if invisible and not overridden
@@ -4678,6 +4824,14 @@ void cata_tiles::void_monster_override()
     monster_override.clear();
 }
 
+bool cata_tiles::has_any_draw_override() const
+{
+    return !radiation_override.empty() || !terrain_override.empty() ||
+           !furniture_override.empty() || !graffiti_override.empty() || !trap_override.empty() ||
+           !field_override.empty() || !item_override.empty() || !vpart_override.empty() ||
+           !draw_below_override.empty() || !monster_override.empty();
+}
+
 bool cata_tiles::has_draw_override( const tripoint &p ) const
 {
     return radiation_override.find( tripoint_bub_ms( p ) ) != radiation_override.end() ||
@@ -2,9 +2,11 @@
 #ifndef CATA_SRC_CATA_TILES_H
 #define CATA_SRC_CATA_TILES_H
 
+#include <array>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -12,6 +14,7 @@
 #include <vector>
 
 #include "animation.h"
+#include "calendar.h"
 #include "cata_type_traits.h"
 #include "creature.h"
 #include "cuboid_rectangle.h"
@@ -32,6 +35,7 @@
 class Character;
 class JsonObject;
 class pixel_minimap;
+enum action_id : int;
 
 extern void set_displaybuffer_rendertarget();
 using ter_str_id = string_id<ter_t>;
@@ -116,6 +120,16 @@ class tile_lookup_res
         }
 };
 
+/**
+ * What cata_tiles::find_tile_looks_like finds for an object drawn without a variant, and for
+ * each of its multitile subtiles, so that it only has to be looked up once per tileset.
+ */
+struct resolved_tile {
+    bool resolved = false;
+    std::optional<tile_lookup_res> tile;
+    std::array<std::optional<tile_lookup_res>, num_multitile_types> subtiles;
+};
+
 class texture
 {
     private:
@@ -480,6 +494,12 @@ class cata_tiles
         find_tile_looks_like_by_string_id( std::string_view id, TILE_CATEGORY category,
                                            int looks_like_jumps_limit ) const;
 
+        /**
+         * find_tile_looks_like( id, category, "" ) for the object of the given category whose
+         * int_id is index, looked up on first use and then reused until the next load_tileset.
+         */
+        const resolved_tile &resolve_tile( TILE_CATEGORY category, int index, const std::string &id );
+
         bool find_overlay_looks_like( bool male, const std::string &overlay, const std::string &variant,
                                       std::string &draw_id );
 
@@ -506,13 +526,17 @@ class cata_tiles
                                   const std::string &subcategory, const tripoint &pos, int subtile, int rota,
                                   lit_level ll, bool apply_night_vision_goggles, int &height_3d, int intensity_level,
                                   const std::string &variant, const point &offset );
+        bool draw_from_id_string( const std::string &id, const resolved_tile &resolved,
+                                  TILE_CATEGORY category, const tripoint &pos, int subtile, int rota,
+                                  lit_level ll, bool apply_night_vision_goggles, int &height_3d );
         bool draw_from_id_string_internal( const std::string &id, const tripoint &pos, int subtile,
                                            int rota,
                                            lit_level ll, int retract, bool apply_night_vision_goggles, int &height_3d );
         bool draw_from_id_string_internal( const std::string &id, TILE_CATEGORY category,
                                            const std::string &subcategory, const tripoint &pos, int subtile, int rota,
                                            lit_level ll, int retract, bool apply_night_vision_goggles, int &height_3d, int intensity_level,
-                                           const std::string &variant, const point &offset );
+                                           const std::string &variant, const point &offset,
+                                           const resolved_tile *resolved = nullptr );
         bool draw_sprite_at(
             const tile_type &tile, const weighted_int_list<std::vector<int>> &svlist,
             const point &, unsigned int loc_rand, bool rota_fg, int rota, lit_level ll,
@@ -680,6 +704,7 @@ class cata_tiles
         void void_monster_override();
 
         bool has_draw_override( const tripoint &p ) const;
+        bool has_any_draw_override() const;
 
         void set_disable_occlusion( bool val );
 
@@ -754,6 +779,12 @@ class cata_tiles
 
         void tile_loading_report_dups();
 
+        /** Draws the animations and cursors on top of the map, the last step of draw(). */
+        void draw_animations_and_cursors( const tripoint &center,
+                                          std::multimap<point, formatted_text> &overlay_strings );
+        /** Copies the map drawn into the given area to last_frame, see there. */
+        void retain_frame( const SDL_Rect &area );
+
         /** Lighting */
         void init_light();
 
@@ -762,6 +793,10 @@ class cata_tiles
         const GeometryRenderer_Ptr &geometry;
         tileset_cache &cache;
         std::shared_ptr<const tileset> tileset_ptr;
+        // See resolve_tile, indexed by category, season and int_id. Cleared by load_tileset, which
+        // also runs whenever the game data is loaded and the int_ids may have changed.
+        std::array<std::array<std::vector<resolved_tile>, NUM_SEASONS>,
+            static_cast<size_t>( TILE_CATEGORY::last )> resolved_tiles;
 
         // the scaled default sprite width and height. in non-isometric mode,
         // the basic tile width and height equal the default sprite width and
@@ -781,6 +816,32 @@ class cata_tiles
 
         bool in_animation = false;
 
+        /**
+         * The map as it was drawn by the last call to draw(), which is copied back instead of
+         * drawing the map again while nothing it was drawn from has changed, e.g. while a menu
+         * is open on top of it.
+         */
+        struct retained_frame {
+            SDL_Texture_Ptr texture;
+            bool valid = false;
+            // What the map was drawn from, besides the map itself. Changes to the map are
+            // caught by the map's draw points cache becoming dirty and by time passing.
+            point dest;
+            tripoint center;
+            point size;
+            point tile_size;
+            const tileset *tiles = nullptr;
+            time_point turn;
+            int moves = 0;
+            // The debug overlay shown over the map, see game::display_toggle_overlay.
+            std::optional<action_id> overlay;
+            const Creature *visibility_creature = nullptr;
+            int lighting_condition = 0;
+        };
+        retained_frame last_frame;
+        // Set when an idle animation sprite is drawn, as those change from frame to frame.
+        bool drew_animated_tile = false;
+
         bool disable_occlusion = false;
 
         bool do_draw_explosion = false;
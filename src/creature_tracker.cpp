@@ -1,14 +1,17 @@
 #include "creature_tracker.h"
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <ostream>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "avatar.h"
 #include "cata_assert.h"
+#include "coordinates.h"
 #include "debug.h"
 #include "flood_fill.h"
 #include "game.h"
@@ -92,7 +95,7 @@ bool creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.get_location()] = critter_ptr;
+    set_location( critter.get_location(), critter_ptr );
     return true;
 }
 
@@ -127,8 +130,8 @@ bool creature_tracker::update_pos( const monster &critter, const tripoint_abs_ms
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( old_pos );
-        monsters_by_location[new_pos] = *iter;
+        erase_location( old_pos );
+        set_location( new_pos, *iter );
         return true;
     } else {
         // We're changing the x/y/z coordinates of a zombie that hasn't been added
@@ -145,7 +148,7 @@ void creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.get_location() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( critter.get_location() );
         return;
     }
 
@@ -156,7 +159,64 @@ void creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( tripoint_abs_ms( iter->first ) );
+    }
+}
+
+void creature_tracker::set_location( const tripoint_abs_ms &pos,
+                                     const shared_ptr_fast<monster> &critter )
+{
+    erase_location( pos );
+    monsters_by_location[pos] = critter;
+    monsters_by_submap[project_to<coords::sm>( pos )].push_back( critter.get() );
+}
+
+void creature_tracker::erase_location( const tripoint_abs_ms &pos )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter == monsters_by_location.end() ) {
+        return;
+    }
+    const auto bucket_iter = monsters_by_submap.find( project_to<coords::sm>( pos ) );
+    if( bucket_iter != monsters_by_submap.end() ) {
+        std::vector<monster *> &bucket = bucket_iter->second;
+        const auto in_bucket = std::find( bucket.begin(), bucket.end(), iter->second.get() );
+        if( in_bucket != bucket.end() ) {
+            *in_bucket = bucket.back();
+            bucket.pop_back();
+        }
+        if( bucket.empty() ) {
+            monsters_by_submap.erase( bucket_iter );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+void creature_tracker::for_each_monster_near( const tripoint_abs_ms &center, const int radius,
+        const int z_radius, const std::function<void( monster & )> &visit_fn ) const
+{
+    const tripoint_abs_ms min = center - tripoint( radius, radius, z_radius );
+    const tripoint_abs_ms max = center + tripoint( radius, radius, z_radius );
+    const tripoint_abs_sm min_sm = project_to<coords::sm>( min );
+    const tripoint_abs_sm max_sm = project_to<coords::sm>( max );
+    for( int z = min_sm.z(); z <= max_sm.z(); ++z ) {
+        for( int x = min_sm.x(); x <= max_sm.x(); ++x ) {
+            for( int y = min_sm.y(); y <= max_sm.y(); ++y ) {
+                const auto bucket_iter = monsters_by_submap.find( tripoint_abs_sm( x, y, z ) );
+                if( bucket_iter == monsters_by_submap.end() ) {
+                    continue;
+                }
+                for( monster *critter : bucket_iter->second ) {
+                    const tripoint_abs_ms &pos = critter->get_location();
+                    if( critter->is_dead() ||
+                        pos.x() < min.x() || pos.x() > max.x() ||
+                        pos.y() < min.y() || pos.y() > max.y() ) {
+                        continue;
+                    }
+                    visit_fn( *critter );
+                }
+            }
+        }
     }
 }
 
@@ -180,6 +240,7 @@ void creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     removed_this_turn_.clear();
     creatures_by_zone_and_faction_.clear();
     invalidate_reachability_cache();
@@ -188,8 +249,9 @@ void creature_tracker::clear()
 void creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->get_location()] = mon_ptr;
+        set_location( mon_ptr->get_location(), mon_ptr );
     }
 }
 
@@ -232,14 +294,14 @@ void creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
     }
+    erase_location( first.get_location() );
+    erase_location( second.get_location() );
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
     const tripoint_abs_ms temp = second.get_location();
@@ -248,10 +310,10 @@ void creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.get_location()] = first_ptr;
+        set_location( first.get_location(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.get_location()] = second_ptr;
+        set_location( second.get_location(), second_ptr );
     }
 }
 
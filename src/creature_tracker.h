@@ -3,6 +3,7 @@
 #define CATA_SRC_CREATURE_TRACKER_H
 
 #include <cstddef>
+#include <functional>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -70,6 +71,15 @@ class creature_tracker
         void for_each_reachable( const Creature &origin, FactionPredicateFn &&faction_fn,
                                  CreatureVisitFn &&creature_fn );
 
+        /**
+         * Visits the monsters at most radius tiles away from center horizontally, and at most
+         * z_radius levels above or below it.  Only the submaps overlapping that box are looked
+         * at, so the cost depends on the local crowd rather than on all monsters in the game.
+         * Dead monsters are ignored and not visited.
+         */
+        void for_each_monster_near( const tripoint_abs_ms &center, int radius, int z_radius,
+                                    const std::function<void( monster & )> &visit_fn ) const;
+
         /**
          * Returns a temporary id of the given monster (which must exist in the tracker).
          * The id is valid until monsters are added or removed from the tracker.
@@ -142,6 +152,9 @@ class creature_tracker
     private:
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /** Add and remove entries of @ref monsters_by_location and @ref monsters_by_submap. */
+        void set_location( const tripoint_abs_ms &pos, const shared_ptr_fast<monster> &critter );
+        void erase_location( const tripoint_abs_ms &pos );
 
         void flood_fill_zone( const Creature &origin );
 
@@ -154,6 +167,9 @@ class creature_tracker
         std::vector<shared_ptr_fast<monster>> monsters_list;
         // NOLINTNEXTLINE(cata-serialize)
         std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>> monsters_by_location;
+        // The same monsters bucketed by the submap they are in, for proximity queries.
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<tripoint_abs_sm, std::vector<monster *>> monsters_by_submap;
 
         /**
          * Creatures that get removed via @ref remove are stored here until the end of the turn.
@@ -111,6 +111,30 @@ static bool capturing = false;
 /** сaptured debug messages */
 static std::string captured;
 
+/** When set, debugmsg calls on this thread are recorded here, see defer_debugmsgs_during */
+static thread_local std::vector<deferred_debugmsg> *deferred_debugmsgs = nullptr;
+/** The DebugLog line being written while deferring, recorded once the next one starts. */
+static thread_local std::ostringstream deferred_log;
+static thread_local bool deferred_log_pending = false;
+static thread_local DebugLevel deferred_log_level = D_INFO;
+static thread_local DebugClass deferred_log_class = DC_ALL;
+
+static void record_deferred_log()
+{
+    if( !deferred_log_pending ) {
+        return;
+    }
+    deferred_debugmsg msg;
+    msg.text = deferred_log.str();
+    msg.is_log = true;
+    msg.log_level = deferred_log_level;
+    msg.log_class = deferred_log_class;
+    deferred_debugmsgs->push_back( std::move( msg ) );
+    deferred_log.str( std::string() );
+    deferred_log.clear();
+    deferred_log_pending = false;
+}
+
 #if defined(_WIN32) and defined(LIBBACKTRACE)
 // Get the image base of a module from its PE header
 static uintptr_t get_image_base( const char *const path )
@@ -204,6 +228,33 @@ capture_debugmsg::~capture_debugmsg()
     capturing = false;
 }
 
+std::vector<deferred_debugmsg> defer_debugmsgs_during( const std::function<void()> &func )
+{
+    std::vector<deferred_debugmsg> ret;
+    std::vector<deferred_debugmsg> *const prev = deferred_debugmsgs;
+    if( prev != nullptr ) {
+        record_deferred_log();
+    }
+    deferred_debugmsgs = &ret;
+    on_out_of_scope restore( [prev]() {
+        record_deferred_log();
+        deferred_debugmsgs = prev;
+    } );
+    func();
+    return ret;
+}
+
+void replay_deferred_debugmsgs( const std::vector<deferred_debugmsg> &msgs )
+{
+    for( const deferred_debugmsg &msg : msgs ) {
+        if( msg.is_log ) {
+            DebugLog( msg.log_level, msg.log_class ) << msg.text;
+        } else {
+            realDebugmsg( msg.filename.c_str(), msg.line.c_str(), msg.funcname.c_str(), msg.text );
+        }
+    }
+}
+
 bool debug_has_error_been_observed()
 {
     return error_observed;
@@ -520,6 +571,12 @@ void realDebugmsg( const char *filename, const char *line, const char *funcname,
     cata_assert( line != nullptr );
     cata_assert( funcname != nullptr );
 
+    if( deferred_debugmsgs != nullptr ) {
+        record_deferred_log();
+        deferred_debugmsgs->push_back( { filename, line, funcname, text } );
+        return;
+    }
+
     if( capturing ) {
         captured += text;
     } else {
@@ -1450,6 +1507,16 @@ void output_repetitions( std::ostream &out )
 
 std::ostream &DebugLog( DebugLevel lev, DebugClass cl )
 {
+    if( deferred_debugmsgs != nullptr ) {
+        // The log file is not safe to write from several threads, so this is written once
+        // the messages are replayed on the main thread.
+        record_deferred_log();
+        deferred_log_pending = true;
+        deferred_log_level = lev;
+        deferred_log_class = cl;
+        return deferred_log;
+    }
+
     if( lev & D_ERROR ) {
         error_observed = true;
     }
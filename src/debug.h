@@ -49,7 +49,9 @@
 // Includes                                                         {{{1
 // ---------------------------------------------------------------------
 #include <iostream>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #define STRING2(x) #x
 #define STRING(x) STRING2(x)
@@ -212,6 +214,28 @@ bool debug_has_error_been_observed();
  */
 std::string capture_debugmsg_during( const std::function<void()> &func );
 
+/** A debugmsg call or DebugLog line that was recorded instead of being reported immediately. */
+struct deferred_debugmsg {
+    std::string filename;
+    std::string line;
+    std::string funcname;
+    std::string text;
+    // Set for a line written to DebugLog, which only uses text.
+    bool is_log = false;
+    DebugLevel log_level = D_INFO;
+    DebugClass log_class = DC_ALL;
+};
+
+/**
+ * Runs func, recording every debugmsg raised and every line written to DebugLog on the
+ * calling thread instead of reporting it.  Lets work run on a worker thread; the main
+ * thread reports the recorded messages afterwards via replay_deferred_debugmsgs.
+ */
+std::vector<deferred_debugmsg> defer_debugmsgs_during( const std::function<void()> &func );
+
+/** Reports messages recorded by defer_debugmsgs_during, in order.  Main thread only. */
+void replay_deferred_debugmsgs( const std::vector<deferred_debugmsg> &msgs );
+
 /**
  * Should be called after catacurses::stdscr is initialized.
  * If catacurses::stdscr is available, shows all buffered debugmsg prompts.
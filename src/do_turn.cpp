@@ -269,6 +269,14 @@ void monmove()
     map &m = get_map();
     avatar &u = get_avatar();
 
+    // Work out the lines of sight the monsters are about to check in plan() on the worker pool.
+    // Planning and moving stay serial and in order, they just find the answers cached.
+    std::vector<map::sight_line> sight_lines;
+    for( const monster &critter : g->all_monsters() ) {
+        critter.add_plan_sight_lines( sight_lines );
+    }
+    m.cache_sight_lines( sight_lines );
+
     for( monster &critter : g->all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && ( m.impassable( critter.pos_bub() ) &&
@@ -469,7 +477,7 @@ bool do_turn()
     play_music( music::get_music_id_string() );
 
     // starting a new turn, clear out temperature cache
-    weather.temperature_cache.clear();
+    weather.clear_temp_cache();
 
     if( g->npcs_dirty ) {
         g->load_npcs();
@@ -62,6 +62,11 @@
 #include "vehicle.h"
 #include "vpart_position.h"
 
+#if defined(TILES)
+#include "cata_tiles.h"
+#include "sdltiles.h"
+#endif
+
 // NOLINTNEXTLINE(cata-static-int_id-constants)
 static const ter_id undefined_ter_id( -1 );
 
@@ -520,6 +525,10 @@ void editmap::do_ui_invalidation()
 {
     avatar &player_character = get_avatar();
     player_character.view_offset = target - player_character.pos_bub();
+#if defined(TILES)
+    // Edits are drawn straight away, mark cata_tiles draw caches as dirty
+    tilecontext->set_draw_cache_dirty();
+#endif
     g->invalidate_main_ui_adaptor();
     create_or_get_ui_adaptor()->invalidate_ui();
 }
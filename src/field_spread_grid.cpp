@@ -0,0 +1,198 @@
+#include "field_spread_grid.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include "field.h"
+#include "field_type.h"
+#include "game.h"
+#include "game_constants.h"
+#include "level_cache.h"
+#include "map.h"
+#include "overmapbuffer.h"
+#include "submap.h"
+#include "weather.h"
+
+field_spread_grid::field_spread_grid( const field_type_id &type )
+    : type( type ), max_intensity( type->get_max_intensity() )
+{
+}
+
+void field_spread_grid::spread_gases( map &here )
+{
+    std::map<field_type_id, field_spread_grid> grids;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        const auto &field_cache = here.get_cache( z ).field_cache;
+        for( int x = 0; x < here.getmapsize(); x++ ) {
+            for( int y = 0; y < here.getmapsize(); y++ ) {
+                if( !field_cache[ x + y * MAPSIZE ] ) {
+                    continue;
+                }
+                const submap *const sm = here.get_submap_at_grid( tripoint_rel_sm{ x, y, z } );
+                if( sm == nullptr ) {
+                    continue;
+                }
+                for( int lx = 0; lx < SEEX; lx++ ) {
+                    for( int ly = 0; ly < SEEY; ly++ ) {
+                        const field &curfield = sm->get_field( { lx, ly } );
+                        if( !curfield.displayed_field_type() ) {
+                            continue;
+                        }
+                        for( const std::pair<const field_type_id, field_entry> &fd : curfield ) {
+                            if( !fd.second.is_field_alive() || !fd.first->gas_can_spread() ) {
+                                continue;
+                            }
+                            const tripoint_bub_ms p( x * SEEX + lx, y * SEEY + ly, z );
+                            grids.try_emplace( fd.first, fd.first ).first->second.add( p,
+                                    fd.second.get_field_intensity(), fd.second.get_field_age() );
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for( std::pair<const field_type_id, field_spread_grid> &grid : grids ) {
+        grid.second.spread( here );
+    }
+}
+
+void field_spread_grid::add( const tripoint_bub_ms &p, const int intensity,
+                             const time_duration &age )
+{
+    entries.push_back( { p, intensity, age } );
+}
+
+int field_spread_grid::cell( const tripoint_bub_ms &p )
+{
+    return p.x() + p.y() * MAPSIZE_X;
+}
+
+field_spread_grid::level *field_spread_grid::level_at( const int z )
+{
+    if( levels.empty() || z < levels.front().z || z > levels.back().z ) {
+        return nullptr;
+    }
+    return &levels[z - levels.front().z];
+}
+
+bool field_spread_grid::can_enter( map &here, const tripoint_bub_ms &p, const int intensity )
+{
+    level *const lev = level_at( p.z() );
+    if( lev == nullptr || !here.inbounds( p ) ) {
+        return false;
+    }
+    // Like map::gas_can_spread_to, but against the gas at the start of the turn, and
+    // without piling up more than the tile can hold.
+    const int c = cell( p );
+    if( lev->intensity[c] >= intensity || lev->next_intensity[c] >= max_intensity ) {
+        return false;
+    }
+    if( lev->open[c] == 0 ) {
+        lev->open[c] = map::gas_can_enter( here.maptile_at_internal( p ) ) ? 1 : 2;
+    }
+    return lev->open[c] == 1;
+}
+
+void field_spread_grid::move( const tripoint_bub_ms &from, const tripoint_bub_ms &to )
+{
+    level &src = *level_at( from.z() );
+    level &dst = *level_at( to.z() );
+    const int f = cell( from );
+    const int t = cell( to );
+    // Ages are shared, as in map::gas_spread_to.
+    const time_duration age_fraction = src.age[f] / src.intensity[f];
+    src.next_intensity[f] -= 1;
+    src.next_age[f] -= age_fraction;
+    if( dst.next_intensity[t] == 0 ) {
+        dst.next_age[t] = age_fraction;
+    } else {
+        dst.next_age[t] += age_fraction;
+    }
+    dst.next_intensity[t] += 1;
+    changed.push_back( from );
+    changed.push_back( to );
+}
+
+void field_spread_grid::spread( map &here )
+{
+    if( entries.empty() ) {
+        return;
+    }
+    const auto z_range = std::minmax_element( entries.begin(), entries.end(),
+    []( const entry & lhs, const entry & rhs ) {
+        return lhs.p.z() < rhs.p.z();
+    } );
+    // The levels above and below, which the gas may rise or fall to.
+    const int min_z = std::max( z_range.first->p.z() - 1, -OVERMAP_DEPTH );
+    const int max_z = std::min( z_range.second->p.z() + 1, OVERMAP_HEIGHT );
+    levels.resize( max_z - min_z + 1 );
+    for( int z = min_z; z <= max_z; z++ ) {
+        level &lev = levels[z - min_z];
+        lev.z = z;
+        lev.intensity.assign( MAPSIZE_X * MAPSIZE_Y, 0 );
+        lev.age.assign( MAPSIZE_X * MAPSIZE_Y, 0_turns );
+        lev.open.assign( MAPSIZE_X * MAPSIZE_Y, 0 );
+    }
+    // Newborn fields are not processed, and a single unit of gas does not spread.
+    std::vector<tripoint_bub_ms> sources;
+    for( const entry &e : entries ) {
+        level &lev = *level_at( e.p.z() );
+        lev.intensity[cell( e.p )] = e.intensity;
+        lev.age[cell( e.p )] = e.age;
+        if( e.intensity > 1 && e.age != 0_turns ) {
+            sources.push_back( e.p );
+        }
+    }
+    if( sources.empty() ) {
+        return;
+    }
+    for( level &lev : levels ) {
+        lev.next_intensity = lev.intensity;
+        lev.next_age = lev.age;
+    }
+
+    const weather_manager &weather = get_weather();
+    const int winddirection = weather.winddirection;
+    const int percent_spread = type->percent_spread;
+    for( const tripoint_bub_ms &p : sources ) {
+        const int current_intensity = level_at( p.z() )->intensity[cell( p )];
+        const bool sheltered = g->is_sheltered( p );
+        const tripoint_abs_ms abs_p = here.getglobal( p );
+        const int windpower = get_local_windpower( weather.windspeed,
+                              overmap_buffer.ter( coords::project_to<coords::omt>( abs_p ) ), abs_p, winddirection,
+                              sheltered );
+        const std::optional<tripoint_bub_ms> target = here.gas_spread_target( p, percent_spread,
+                windpower, sheltered, winddirection,
+        [&]( const tripoint_bub_ms & dst, const maptile & ) {
+            return can_enter( here, dst, current_intensity );
+        } );
+        if( target ) {
+            move( p, *target );
+        }
+    }
+    store( here );
+}
+
+void field_spread_grid::store( map &here )
+{
+    std::sort( changed.begin(), changed.end() );
+    changed.erase( std::unique( changed.begin(), changed.end() ), changed.end() );
+    for( const tripoint_bub_ms &p : changed ) {
+        const level &lev = *level_at( p.z() );
+        const int c = cell( p );
+        if( lev.next_intensity[c] == lev.intensity[c] && lev.next_age[c] == lev.age[c] ) {
+            continue;
+        }
+        if( lev.intensity[c] == 0 ) {
+            if( here.add_field( p, type, lev.next_intensity[c], 0_turns ) ) {
+                here.set_field_age( p, type, lev.next_age[c] );
+            }
+        } else {
+            here.set_field_intensity( p, type, lev.next_intensity[c] );
+            here.set_field_age( p, type, lev.next_age[c] );
+        }
+    }
+    changed.clear();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef CATA_SRC_FIELD_SPREAD_GRID_H
+#define CATA_SRC_FIELD_SPREAD_GRID_H
+
+#include <cstdint>
+#include <vector>
+
+#include "calendar.h"
+#include "coordinates.h"
+#include "type_id.h"
+
+class map;
+
+/**
+ * Spreads one type of gas over the whole map at once, instead of map::spread_gas moving it
+ * one tile after another (see the GAS_SPREAD_GRID option).
+ *
+ * The intensities and ages of the gas are copied into dense grids, one per z-level it can
+ * reach.  Every tile decides where its gas goes based on the intensities at the start of the
+ * turn, and the moves are written to a second set of grids, so the order in which tiles are
+ * visited does not matter.  Only the tiles that changed are written back to their fields.
+ *
+ * Where the gas of a tile goes is decided by map::gas_spread_target, as in map::spread_gas;
+ * the other effects of the gas (scent, outdoor aging, decay) are left to the usual field
+ * processing.
+ */
+class field_spread_grid
+{
+    public:
+        explicit field_spread_grid( const field_type_id &type );
+
+        /** Spreads every gas on here by one turn. */
+        static void spread_gases( map &here );
+
+        /** Adds the gas of a tile, which must be of the type of the grid. */
+        void add( const tripoint_bub_ms &p, int intensity, const time_duration &age );
+        /** Moves the gas added so far and writes the result back to here. */
+        void spread( map &here );
+
+    private:
+        struct level {
+            int z = 0;
+            // Indexed by cell(), the state at the start of the turn and the one being built.
+            std::vector<int> intensity;
+            std::vector<time_duration> age;
+            std::vector<int> next_intensity;
+            std::vector<time_duration> next_age;
+            // 0 not checked yet, 1 gas can enter, 2 it cannot.
+            std::vector<uint8_t> open;
+        };
+
+        struct entry {
+            tripoint_bub_ms p;
+            int intensity;
+            time_duration age;
+        };
+
+        static int cell( const tripoint_bub_ms &p );
+        level *level_at( int z );
+        bool can_enter( map &here, const tripoint_bub_ms &p, int intensity );
+        void move( const tripoint_bub_ms &from, const tripoint_bub_ms &to );
+        void store( map &here );
+
+        field_type_id type;
+        int max_intensity;
+        std::vector<entry> entries;
+        std::vector<level> levels;
+        std::vector<tripoint_bub_ms> changed;
+};
+
+#endif // CATA_SRC_FIELD_SPREAD_GRID_H
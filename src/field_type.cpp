@@ -347,6 +347,7 @@ void field_type::finalize()
 
     // should be the last operation for the type
     processors = map_field_processing::processors_for_type( *this );
+    local_processing = map_field_processing::processors_are_local( processors );
 }
 
 void field_type::check() const
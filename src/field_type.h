@@ -238,6 +238,9 @@ struct field_type {
         bool transparent = false;
 
         std::vector<map_field_processing::FieldProcessorPtr> processors;
+        // Processing only touches the tile itself and the fields of its neighbors,
+        // see map_field_processing::processors_are_local
+        bool local_processing = false;
 
     public:
         const field_intensity_level &get_intensity_level( int level = 0 ) const;
@@ -264,6 +267,9 @@ struct field_type {
         const std::vector<map_field_processing::FieldProcessorPtr> &get_processors() const {
             return processors;
         }
+        bool has_local_processing() const {
+            return local_processing;
+        }
 
         static size_t count();
 };
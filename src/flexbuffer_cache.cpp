@@ -1,12 +1,15 @@
 #include "flexbuffer_cache.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -286,10 +289,12 @@ class flexbuffer_disk_cache
         }
 
         bool has_cached_flexbuffer_for_json( const fs::path &json_source_path ) {
+            std::lock_guard<std::mutex> lk( mutex_ );
             return cached_flexbuffers_.count( json_source_path.u8string() ) > 0;
         }
 
         fs::file_time_type cached_mtime_for_json( const fs::path &json_source_path ) {
+            std::lock_guard<std::mutex> lk( mutex_ );
             auto it = cached_flexbuffers_.find( json_source_path.u8string() );
             if( it != cached_flexbuffers_.end() ) {
                 return it->second.mtime;
@@ -305,9 +310,15 @@ class flexbuffer_disk_cache
                     root_path_ ).lexically_normal();
 
             // Is there even a potential cached flexbuffer for this file.
-            auto disk_entry = cached_flexbuffers_.find( root_relative_source_path.u8string() );
-            if( disk_entry == cached_flexbuffers_.end() ) {
-                return storage;
+            const std::string root_relative_source_path_string = root_relative_source_path.u8string();
+            disk_cache_entry entry;
+            {
+                std::lock_guard<std::mutex> lk( mutex_ );
+                auto disk_entry = cached_flexbuffers_.find( root_relative_source_path_string );
+                if( disk_entry == cached_flexbuffers_.end() ) {
+                    return storage;
+                }
+                entry = disk_entry->second;
             }
 
             std::error_code ec;
@@ -317,16 +328,17 @@ class flexbuffer_disk_cache
             }
 
             // Does the source file's mtime match what we cached previously
-            if( source_mtime != disk_entry->second.mtime ) {
+            if( source_mtime != entry.mtime ) {
                 // Cached flexbuffer on disk is out of date, remove it.
-                remove_file( disk_entry->second.flexbuffer_path.u8string() );
-                cached_flexbuffers_.erase( disk_entry );
+                remove_file( entry.flexbuffer_path.u8string() );
+                std::lock_guard<std::mutex> lk( mutex_ );
+                cached_flexbuffers_.erase( root_relative_source_path_string );
                 return storage;
             }
 
             // Try to mmap the cached flexbuffer
             std::shared_ptr<mmap_file> mmap_handle = mmap_file::map_file(
-                        disk_entry->second.flexbuffer_path.u8string() );
+                        entry.flexbuffer_path.u8string() );
             if( !mmap_handle ) {
                 return storage;
             }
@@ -368,6 +380,7 @@ class flexbuffer_disk_cache
             }
 
             fb.close();
+            std::lock_guard<std::mutex> lk( mutex_ );
             cached_flexbuffers_[json_source_path_string] = disk_cache_entry{ flexbuffer_path, mtime };
 
             return true;
@@ -385,7 +398,9 @@ class flexbuffer_disk_cache
             fs::file_time_type mtime;
         };
         // Maps game root relative json source path to the most recent cached flexbuffer we have on disk for it.
+        // Guarded by mutex_, files may be parsed on several threads at once.
         std::unordered_map<std::string, disk_cache_entry> cached_flexbuffers_;
+        std::mutex mutex_;
 };
 
 flexbuffer_cache::flexbuffer_cache( const fs::path &cache_directory,
@@ -477,3 +492,265 @@ std::shared_ptr<parsed_flexbuffer> flexbuffer_cache::parse_buffer( std::string b
     auto storage = std::make_shared<flexbuffer_vector_storage>( std::move( fb ) );
     return std::make_shared<string_flexbuffer>( std::move( storage ), std::move( buffer ) );
 }
+
+namespace
+{
+
+// Bump whenever the layout written by flexbuffer_snapshot::save changes.
+constexpr uint32_t snapshot_format_version = 1;
+constexpr char snapshot_magic[8] = { 'C', 'D', 'D', 'A', 'S', 'N', 'A', 'P' };
+// Flexbuffers read scalars in place, so keep every buffer suitably aligned.
+constexpr size_t snapshot_alignment = 16;
+// How many sets of files saved under one name keep their snapshot, see flexbuffer_snapshot::save.
+constexpr size_t max_snapshots_per_name = 8;
+
+struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+};
+
+struct snapshot_index_entry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// FNV-1a, because the key must be stable between builds and std::hash makes no such promise.
+void hash_bytes( uint64_t &hash, const void *data, size_t len )
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>( data );
+    for( size_t i = 0; i < len; ++i ) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+void hash_string( uint64_t &hash, const std::string &str )
+{
+    // Include the terminator so that { "ab", "c" } and { "a", "bc" } differ.
+    hash_bytes( hash, str.c_str(), str.size() + 1 );
+}
+
+std::string hash_to_string( uint64_t hash )
+{
+    std::ostringstream os;
+    os << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash;
+    return os.str();
+}
+
+size_t align_snapshot_offset( size_t offset )
+{
+    return ( offset + snapshot_alignment - 1 ) / snapshot_alignment * snapshot_alignment;
+}
+
+} // namespace
+
+struct flexbuffer_snapshot_storage : flexbuffer_storage {
+    std::shared_ptr<mmap_file> mmap_handle_;
+    size_t offset_;
+    size_t size_;
+
+    flexbuffer_snapshot_storage( std::shared_ptr<mmap_file> mmap_handle, size_t offset, size_t size )
+        : mmap_handle_{ std::move( mmap_handle ) }, offset_{ offset }, size_{ size } {}
+
+    const uint8_t *data() const override {
+        return mmap_handle_->base + offset_;
+    }
+    size_t size() const override {
+        return size_;
+    }
+};
+
+struct flexbuffer_snapshot::snapshot_data {
+    fs::path directory;
+    std::string name_hash;
+    // Hash of the source paths, so that e.g. every mod list used with a directory gets a slot.
+    std::string sources_hash;
+    std::vector<fs::path> sources;
+    std::vector<fs::file_time_type> mtimes;
+    // Empty if any source could not be stat-ed, nothing can be snapshotted then.
+    std::string key;
+
+    std::shared_ptr<mmap_file> mapping;
+    std::vector<snapshot_index_entry> index;
+
+    fs::path snapshot_path() const {
+        return directory / fs::u8path( name_hash + "-" + sources_hash + "-" + key + ".snap" );
+    }
+};
+
+flexbuffer_snapshot::flexbuffer_snapshot() : data_( std::make_unique<snapshot_data>() ) {}
+
+flexbuffer_snapshot::~flexbuffer_snapshot() = default;
+
+flexbuffer_snapshot::flexbuffer_snapshot( flexbuffer_snapshot && ) noexcept = default;
+
+flexbuffer_snapshot &flexbuffer_snapshot::operator=( flexbuffer_snapshot && ) noexcept = default;
+
+flexbuffer_snapshot flexbuffer_snapshot::open( const fs::path &snapshot_directory,
+        const std::string &name, std::vector<fs::path> json_source_paths )
+{
+    flexbuffer_snapshot ret;
+    snapshot_data &data = *ret.data_;
+    data.directory = snapshot_directory;
+    data.sources = std::move( json_source_paths );
+
+    uint64_t name_hash = 0xcbf29ce484222325ULL;
+    hash_string( name_hash, name );
+    data.name_hash = hash_to_string( name_hash );
+
+    uint64_t sources_hash = 0xcbf29ce484222325ULL;
+    uint64_t key_hash = 0xcbf29ce484222325ULL;
+    hash_bytes( key_hash, &snapshot_format_version, sizeof( snapshot_format_version ) );
+    data.mtimes.reserve( data.sources.size() );
+    for( const fs::path &source : data.sources ) {
+        std::error_code ec;
+        fs::file_time_type mtime = get_file_mtime_millis( source, ec );
+        if( ec ) {
+            return ret;
+        }
+        const int64_t mtime_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                                 ( mtime.time_since_epoch() ).count();
+        hash_string( sources_hash, source.generic_u8string() );
+        hash_bytes( key_hash, &mtime_ms, sizeof( mtime_ms ) );
+        data.mtimes.push_back( mtime );
+    }
+    data.sources_hash = hash_to_string( sources_hash );
+    data.key = hash_to_string( key_hash );
+
+    const fs::path snapshot_path = data.snapshot_path();
+    if( !file_exist( snapshot_path ) ) {
+        return ret;
+    }
+    std::shared_ptr<mmap_file> mapping = mmap_file::map_file( snapshot_path );
+    if( !mapping || mapping->len < sizeof( snapshot_header ) ) {
+        return ret;
+    }
+
+    snapshot_header header;
+    memcpy( &header, mapping->base, sizeof( header ) );
+    if( memcmp( header.magic, snapshot_magic, sizeof( snapshot_magic ) ) != 0 ||
+        header.version != snapshot_format_version || header.count != data.sources.size() ||
+        mapping->len < sizeof( header ) + header.count * sizeof( snapshot_index_entry ) ) {
+        return ret;
+    }
+
+    std::vector<snapshot_index_entry> index( header.count );
+    if( header.count > 0 ) {
+        memcpy( index.data(), mapping->base + sizeof( header ),
+                header.count * sizeof( snapshot_index_entry ) );
+    }
+    for( const snapshot_index_entry &entry : index ) {
+        if( entry.offset % snapshot_alignment != 0 || entry.offset > mapping->len ||
+            entry.size > mapping->len - entry.offset ) {
+            // Truncated or otherwise damaged, it will be rewritten.
+            return ret;
+        }
+    }
+
+    data.mapping = std::move( mapping );
+    data.index = std::move( index );
+    return ret;
+}
+
+bool flexbuffer_snapshot::is_loaded() const
+{
+    return data_->mapping != nullptr;
+}
+
+std::shared_ptr<parsed_flexbuffer> flexbuffer_snapshot::get( size_t index ) const
+{
+    const snapshot_index_entry &entry = data_->index.at( index );
+    auto storage = std::make_shared<flexbuffer_snapshot_storage>( data_->mapping,
+                   static_cast<size_t>( entry.offset ), static_cast<size_t>( entry.size ) );
+    fs::path source = data_->sources[index];
+    return std::make_shared<file_flexbuffer>( std::move( storage ), std::move( source ),
+            data_->mtimes[index], 0 );
+}
+
+bool flexbuffer_snapshot::save( const std::vector<shared_flexbuffer> &flexbuffers ) const
+{
+    const snapshot_data &data = *data_;
+    if( data.key.empty() || flexbuffers.size() != data.sources.size() ||
+        !assure_dir_exist( data.directory ) ) {
+        return false;
+    }
+
+    snapshot_header header;
+    memcpy( header.magic, snapshot_magic, sizeof( snapshot_magic ) );
+    header.version = snapshot_format_version;
+    header.count = static_cast<uint32_t>( flexbuffers.size() );
+
+    std::vector<snapshot_index_entry> index;
+    index.reserve( flexbuffers.size() );
+    size_t offset = align_snapshot_offset( sizeof( header ) +
+                                           flexbuffers.size() * sizeof( snapshot_index_entry ) );
+    for( const shared_flexbuffer &fb : flexbuffers ) {
+        const size_t size = fb->get_storage()->size();
+        index.push_back( snapshot_index_entry{ offset, size } );
+        offset = align_snapshot_offset( offset + size );
+    }
+
+    // Write under a temporary name so that an interrupted save never leaves a snapshot
+    // that could be picked up on the next launch.
+    const fs::path snapshot_path = data.snapshot_path();
+    fs::path temp_path = snapshot_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream out( temp_path, std::ofstream::binary );
+        if( !out.good() ) {
+            return false;
+        }
+        const char padding[snapshot_alignment] = {};
+        out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+        out.write( reinterpret_cast<const char *>( index.data() ),
+                   index.size() * sizeof( snapshot_index_entry ) );
+        size_t written = sizeof( header ) + index.size() * sizeof( snapshot_index_entry );
+        for( size_t i = 0; i < flexbuffers.size(); ++i ) {
+            out.write( padding, index[i].offset - written );
+            out.write( reinterpret_cast<const char *>( flexbuffers[i]->get_storage()->data() ),
+                       index[i].size );
+            written = index[i].offset + index[i].size;
+        }
+        if( !out.good() ) {
+            out.close();
+            remove_file( temp_path );
+            return false;
+        }
+    }
+    if( !rename_file( temp_path, snapshot_path ) ) {
+        remove_file( temp_path );
+        return false;
+    }
+
+    // Snapshots of older versions of the same files can never be used again.  Other sets of
+    // files under the same name (e.g. the same directory with a different mod list) are kept,
+    // up to max_snapshots_per_name of the most recently written ones.
+    const std::string name_prefix = data.name_hash + "-";
+    const std::string sources_prefix = name_prefix + data.sources_hash + "-";
+    const std::string current = snapshot_path.filename().u8string();
+    std::vector<std::pair<fs::file_time_type, fs::path>> others;
+    for( const std::string &old : get_files_from_path( ".snap", data.directory.u8string(), false,
+            true ) ) {
+        const fs::path old_path = fs::u8path( old );
+        const std::string filename = old_path.filename().u8string();
+        if( filename == current || filename.compare( 0, name_prefix.size(), name_prefix ) != 0 ) {
+            continue;
+        }
+        if( filename.compare( 0, sources_prefix.size(), sources_prefix ) == 0 ) {
+            remove_file( old_path );
+        } else {
+            std::error_code ec;
+            others.emplace_back( fs::last_write_time( old_path, ec ), old_path );
+        }
+    }
+    if( others.size() >= max_snapshots_per_name ) {
+        std::sort( others.begin(), others.end(), []( const auto & lhs, const auto & rhs ) {
+            return lhs.first > rhs.first;
+        } );
+        for( size_t i = max_snapshots_per_name - 1; i < others.size(); ++i ) {
+            remove_file( others[i].second );
+        }
+    }
+    return true;
+}
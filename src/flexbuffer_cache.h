@@ -4,7 +4,9 @@
 
 #include <iosfwd>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <flatbuffers/flexbuffers.h>
 
@@ -71,4 +73,41 @@ class flexbuffer_cache
         std::unique_ptr<flexbuffer_disk_cache> disk_cache_;
 };
 
+// A single file holding the flexbuffers of a whole set of json files, e.g. everything a mod
+// provides, so that later launches can map the set at once instead of looking up, stat-ing
+// and mapping a cached flexbuffer per file.
+// A snapshot is keyed on the paths and mtimes of its sources.  Editing one of them makes the
+// old snapshot unreachable, it is deleted once a new one is saved.  A different set of paths
+// under the same name, e.g. the mod interaction files of another mod list, gets a snapshot of
+// its own, so switching between worlds does not rewrite them every time.
+class flexbuffer_snapshot
+{
+        using shared_flexbuffer = std::shared_ptr<parsed_flexbuffer>;
+
+    public:
+        // Looks for a snapshot of exactly json_source_paths, in that order, in snapshot_directory.
+        // name identifies the set of files (e.g. the directory they were found in) across launches.
+        static flexbuffer_snapshot open( const fs::path &snapshot_directory, const std::string &name,
+                                         std::vector<fs::path> json_source_paths );
+
+        ~flexbuffer_snapshot();
+        flexbuffer_snapshot( flexbuffer_snapshot && ) noexcept;
+        flexbuffer_snapshot &operator=( flexbuffer_snapshot && ) noexcept;
+
+        // True if a matching snapshot was found and get() can be used.
+        bool is_loaded() const;
+        // Flexbuffer of the json_source_paths[index] passed to open().
+        shared_flexbuffer get( size_t index ) const;
+
+        // Writes flexbuffers, which must correspond to json_source_paths, as the snapshot for
+        // the sources passed to open(). Returns false if it could not be written.
+        bool save( const std::vector<shared_flexbuffer> &flexbuffers ) const;
+
+    private:
+        flexbuffer_snapshot();
+
+        struct snapshot_data;
+        std::unique_ptr<snapshot_data> data_;
+};
+
 #endif // CATA_SRC_FLEXBUFFER_CACHE_H
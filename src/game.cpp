@@ -12778,9 +12778,9 @@ bool game::vertical_shift( const int z_after )
         return false;
     }
 
-    scent.reset();
-
     const int z_before = u.posz();
+    scent.vertical_shift( z_after - z_before );
+
     u.move_to( tripoint_abs_ms( u.get_location().xy(), z_after ) );
 
     // Shift the map itself
@@ -127,7 +127,7 @@ class generic_factory
         // generation or "modification count" of this factory
         // it's incremented when any changes to the inner id containers occur
         // version value corresponds to the string_id::_version,
-        // so incrementing the version here effectively invalidates all cached string_id::_cid
+        // so incrementing the version here effectively invalidates all cached string_id cids
         int64_t  version = 0;
 
         void inc_version() {
@@ -145,8 +145,9 @@ class generic_factory
         std::string id_member_name;
 
         bool find_id( const string_id<T> &id, int_id<T> &result ) const {
-            if( id._version == version ) {
-                result = int_id<T>( id._cid );
+            int cid = INVALID_CID;
+            if( id.get_cid( version, cid ) ) {
+                result = int_id<T>( cid );
                 return is_valid( result );
             }
             const auto iter = map.find( id );
@@ -301,7 +302,7 @@ class generic_factory
          * The function returns the actual object reference.
          */
         T &insert( const T &obj ) {
-            // this invalidates `_cid` cache for all previously added string_ids,
+            // this invalidates the cid cache of all previously added string_ids,
             // but! it's necessary to invalidate cache for all possibly cached "missed" lookups
             // (lookups for not-yet-inserted elements)
             // in the common scenario there is no loss of performance, as `finalize` will make cache
@@ -1,10 +1,15 @@
 #include "init.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <exception>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "achievement.h"
@@ -18,8 +23,10 @@
 #include "bodygraph.h"
 #include "bodypart.h"
 #include "butchery_requirements.h"
+#include "cached_options.h"
 #include "cata_assert.h"
 #include "cata_scope_helpers.h"
+#include "cata_thread_pool.h"
 #include "character_modifier.h"
 #include "city.h"
 #include "climbing.h"
@@ -136,6 +143,165 @@ void check_sigint()
     }
 }
 
+/** One named step of finalization or verification, see run_loading_stages. */
+struct loading_stage {
+    /**
+     * Untranslated name, marked with translate_marker.  Other stages refer to
+     * it in @ref after, it is only translated when shown on the loading screen.
+     */
+    std::string name;
+    std::function<void()> func;
+    /**
+     * Names of the stages whose results this one reads.  It will not start
+     * before they have finished.
+     */
+    std::vector<std::string> after = {};
+    /**
+     * If true the stage runs on the worker pool, alongside other concurrent
+     * stages, as soon as the stages in @ref after are done.  Such a stage must
+     * only write to data it owns, must not touch the UI, and every stage
+     * reading its data has to list it in @ref after.
+     * Other stages run on the main thread in the order they are listed, once
+     * every concurrent stage started before them has finished, as they may
+     * fill lazily built caches the concurrent stages read.
+     */
+    bool concurrent = false;
+};
+
+/**
+ * Runs the stages in dependency order, see @ref loading_stage.  Debug messages
+ * are collected and reported in list order once the stages are done, so the
+ * output does not depend on the number of threads.  The time spent in each
+ * stage is written to the debug log.
+ */
+void run_loading_stages( const std::string &title, const std::vector<loading_stage> &stages )
+{
+    using clock = std::chrono::steady_clock;
+    const clock::time_point started = clock::now();
+    const size_t num_stages = stages.size();
+    std::unordered_map<std::string, size_t> index_of;
+    for( size_t i = 0; i < num_stages; ++i ) {
+        index_of.emplace( stages[i].name, i );
+    }
+    std::vector<std::vector<size_t>> deps( num_stages );
+    for( size_t i = 0; i < num_stages; ++i ) {
+        for( const std::string &dep : stages[i].after ) {
+            auto it = index_of.find( dep );
+            if( it == index_of.end() ) {
+                debugmsg( "%s stage \"%s\" depends on unknown stage \"%s\"", title, stages[i].name,
+                          dep );
+            } else {
+                deps[i].push_back( it->second );
+            }
+        }
+    }
+
+    std::vector<bool> submitted( num_stages, false );
+    std::vector<bool> done( num_stages, false );
+    std::vector<std::vector<deferred_debugmsg>> messages( num_stages );
+    std::vector<clock::duration> durations( num_stages, clock::duration::zero() );
+
+    const auto run_stage = [&]( size_t i ) {
+        const clock::time_point start = clock::now();
+        on_out_of_scope record_duration( [&]() {
+            durations[i] = clock::now() - start;
+        } );
+        messages[i] = defer_debugmsgs_during( stages[i].func );
+    };
+    const auto deps_done = [&]( size_t i ) {
+        return std::all_of( deps[i].begin(), deps[i].end(), [&]( size_t d ) {
+            return done[d];
+        } );
+    };
+
+    std::exception_ptr failure;
+    try {
+        cata::task_group running;
+        // Hands every concurrent stage that became ready to the worker pool.
+        const auto submit_ready = [&]() {
+            for( size_t i = 0; i < num_stages; ++i ) {
+                if( stages[i].concurrent && !submitted[i] && deps_done( i ) ) {
+                    submitted[i] = true;
+                    running.run( [&run_stage, i]() {
+                        run_stage( i );
+                    } );
+                }
+            }
+        };
+        // Waits for the running concurrent stages, returns false if there were none.
+        const auto finish_running = [&]() {
+            bool any = false;
+            running.wait();
+            for( size_t i = 0; i < num_stages; ++i ) {
+                if( submitted[i] && !done[i] ) {
+                    done[i] = true;
+                    any = true;
+                }
+            }
+            check_sigint();
+            return any;
+        };
+
+        for( size_t i = 0; i < num_stages; ++i ) {
+            if( stages[i].concurrent ) {
+                continue;
+            }
+            submit_ready();
+            while( !deps_done( i ) ) {
+                if( !finish_running() ) {
+                    cata_fatal( "%s stage \"%s\" has unmet dependencies", title, stages[i].name );
+                }
+                submit_ready();
+            }
+            finish_running();
+            loading_ui::show( title, _( stages[i].name ) );
+            run_stage( i );
+            done[i] = true;
+            check_sigint();
+        }
+        do {
+            submit_ready();
+        } while( finish_running() );
+        for( size_t i = 0; i < num_stages; ++i ) {
+            if( !done[i] ) {
+                cata_fatal( "%s stage \"%s\" has unmet dependencies", title, stages[i].name );
+            }
+        }
+    } catch( ... ) {
+        failure = std::current_exception();
+    }
+
+    for( const std::vector<deferred_debugmsg> &msgs : messages ) {
+        replay_deferred_debugmsgs( msgs );
+    }
+    if( failure ) {
+        std::rethrow_exception( failure );
+    }
+
+    std::vector<size_t> by_duration( num_stages );
+    for( size_t i = 0; i < num_stages; ++i ) {
+        by_duration[i] = i;
+    }
+    std::stable_sort( by_duration.begin(), by_duration.end(), [&]( size_t l, size_t r ) {
+        return durations[l] > durations[r];
+    } );
+    const auto to_ms = []( clock::duration d ) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>( d ).count();
+    };
+    clock::duration total = clock::duration::zero();
+    for( const clock::duration &d : durations ) {
+        total += d;
+    }
+    std::ostringstream report;
+    report << title << ": " << num_stages << " stages took " << to_ms( clock::now() - started ) <<
+           " ms (" << to_ms( total ) << " ms summed over stages) using " <<
+           cata::parallel_thread_count() << " threads";
+    for( size_t i : by_duration ) {
+        report << "\n    " << stages[i].name << ": " << to_ms( durations[i] ) << " ms";
+    }
+    DebugLog( D_INFO, DC_ALL ) << report.str();
+}
+
 } // namespace
 
 void DynamicDataLoader::load_object( const JsonObject &jo, const std::string &src,
@@ -186,8 +352,10 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
                 debugmsg( "(json-error)\n%s", err.what() );
             }
             ++it;
-            inp_mngr.pump_events();
-            check_sigint();
+            if( !cata::in_parallel_task() ) {
+                inp_mngr.pump_events();
+                check_sigint();
+            }
         }
         data.erase( data.begin(), it );
         if( data.size() == n ) {
@@ -197,7 +365,9 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
                 } catch( const JsonError &err ) {
                     debugmsg( "(json-error)\n%s", err.what() );
                 }
-                inp_mngr.pump_events();
+                if( !cata::in_parallel_task() ) {
+                    inp_mngr.pump_events();
+                }
             }
             data.clear();
             return; // made no progress on this cycle so abort
@@ -535,16 +705,7 @@ void DynamicDataLoader::load_data_from_path( const cata_path &path, const std::s
         files.emplace_back( path );
     }
 
-    // iterate over each file
-    for( const cata_path &file : files ) {
-        try {
-            // parse it
-            JsonValue jsin = json_loader::from_path( file );
-            load_all_from_json( jsin, src, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
-        }
-    }
+    load_files_from_path( files, src, path );
 }
 
 void DynamicDataLoader::load_mod_data_from_path( const cata_path &path, const std::string &src )
@@ -568,15 +729,20 @@ void DynamicDataLoader::load_mod_data_from_path( const cata_path &path, const st
         files.emplace_back( path );
     }
 
-    // iterate over each file
-    for( const cata_path &file : files ) {
-        try {
-            // parse it
-            JsonValue jsin = json_loader::from_path( file );
-            load_all_from_json( jsin, src, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
+    load_files_from_path( files, src, path );
+}
+
+void DynamicDataLoader::load_files_from_path( const std::vector<cata_path> &files,
+        const std::string &src, const cata_path &base_path )
+{
+    try {
+        const std::vector<JsonValue> parsed = json_loader::from_paths( base_path, files,
+                                              data_snapshots );
+        for( size_t i = 0; i < files.size(); ++i ) {
+            load_all_from_json( parsed[i], src, base_path, files[i] );
         }
+    } catch( const JsonError &err ) {
+        throw std::runtime_error( err.what() );
     }
 }
 
@@ -607,15 +773,21 @@ void DynamicDataLoader::load_mod_interaction_files_from_path( const cata_path &p
             }
         }
     }
-    // iterate over each file
+    std::vector<cata_path> file_paths;
+    file_paths.reserve( files.size() );
     for( const std::pair<const mod_id, cata_path> &file : files ) {
-        try {
-            // parse it
-            JsonValue jsin = json_loader::from_path( file.second );
-            load_all_from_json( jsin, string_format( "%s#%s", src, file.first.str() ), path, file.second );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
+        file_paths.push_back( file.second );
+    }
+    try {
+        const std::vector<JsonValue> parsed = json_loader::from_paths( path, file_paths,
+                                              data_snapshots );
+        auto jsin = parsed.begin();
+        for( const std::pair<const mod_id, cata_path> &file : files ) {
+            load_all_from_json( *jsin++, string_format( "%s#%s", src, file.first.str() ), path,
+                                file.second );
         }
+    } catch( const JsonError &err ) {
+        throw std::runtime_error( err.what() );
     }
 }
 
@@ -783,88 +955,96 @@ void DynamicDataLoader::finalize_loaded_data()
     } );
     stream_cache = std::make_unique<cached_streams>();
 
-    using named_entry = std::pair<std::string, std::function<void()>>;
-    const std::vector<named_entry> entries = {{
-            { _( "Flags" ), &json_flag::finalize_all },
-            { _( "Option sliders" ), &option_slider::finalize_all },
-            { _( "Body parts" ), &body_part_type::finalize_all },
-            { _( "Sub body parts" ), &sub_body_part_type::finalize_all },
-            { _( "Body graphs" ), &bodygraph::finalize_all },
-            { _( "Bionics" ), &bionic_data::finalize_bionic },
-            { _( "Weather types" ), &weather_types::finalize_all },
-            { _( "Effect on conditions" ), &effect_on_conditions::finalize_all },
-            { _( "Field types" ), &field_types::finalize_all },
-            { _( "Ammo effects" ), &ammo_effects::finalize_all },
-            { _( "Emissions" ), &emit::finalize },
-            { _( "Materials" ), &material_type::finalize_all },
+    // Stages marked concurrent run on the worker pool between the serial ones, see
+    // loading_stage for the rules they and the stages reading their data follow.
+    const std::vector<loading_stage> stages = {{
+            { translate_marker( "Flags" ), &json_flag::finalize_all },
+            { translate_marker( "Option sliders" ), &option_slider::finalize_all },
+            { translate_marker( "Body parts" ), &body_part_type::finalize_all },
+            { translate_marker( "Sub body parts" ), &sub_body_part_type::finalize_all },
+            { translate_marker( "Body graphs" ), &bodygraph::finalize_all },
+            { translate_marker( "Bionics" ), &bionic_data::finalize_bionic },
+            { translate_marker( "Weather types" ), &weather_types::finalize_all },
+            { translate_marker( "Effect on conditions" ), &effect_on_conditions::finalize_all },
+            { translate_marker( "Field types" ), &field_types::finalize_all },
+            { translate_marker( "Ammo effects" ), &ammo_effects::finalize_all },
+            { translate_marker( "Emissions" ), &emit::finalize },
+            { translate_marker( "Materials" ), &material_type::finalize_all },
             {
-                _( "Items" ), []()
+                translate_marker( "Items" ), []()
                 {
                     item_controller->finalize();
                 }
             },
             {
-                _( "Crafting requirements" ), []()
+                translate_marker( "Crafting requirements" ), []()
                 {
                     requirement_data::finalize();
                 }
             },
-            { _( "Vehicle part categories" ), &vpart_category::finalize },
-            { _( "Vehicle parts" ), &vehicles::parts::finalize },
-            { _( "Traps" ), &trap::finalize },
-            { _( "Terrain" ), &set_ter_ids },
-            { _( "Furniture" ), &set_furn_ids },
-            { _( "Overmap land use codes" ), &overmap_land_use_codes::finalize },
-            { _( "Overmap terrain" ), &overmap_terrains::finalize },
-            { _( "Overmap connections" ), &overmap_connections::finalize },
-            { _( "Overmap specials" ), &overmap_specials::finalize },
-            { _( "Overmap locations" ), &overmap_locations::finalize },
-            { _( "Cities" ), &city::finalize },
-            { _( "Math functions" ), &jmath_func::finalize },
-            { _( "Start locations" ), &start_locations::finalize_all },
-            { _( "Vehicle part migrations" ), &vpart_migration::finalize },
-            { _( "Vehicle prototypes" ), &vehicles::finalize_prototypes },
-            { _( "Mapgen weights" ), &calculate_mapgen_weights },
-            { _( "Mapgen parameters" ), &overmap_specials::finalize_mapgen_parameters },
-            { _( "Behaviors" ), &behavior::finalize },
+            { translate_marker( "Vehicle part categories" ), &vpart_category::finalize },
+            { translate_marker( "Vehicle parts" ), &vehicles::parts::finalize },
+            { translate_marker( "Traps" ), &trap::finalize },
+            { translate_marker( "Terrain" ), &set_ter_ids },
+            { translate_marker( "Furniture" ), &set_furn_ids },
+            { translate_marker( "Overmap land use codes" ), &overmap_land_use_codes::finalize },
+            { translate_marker( "Overmap terrain" ), &overmap_terrains::finalize },
+            { translate_marker( "Overmap connections" ), &overmap_connections::finalize },
+            {
+                translate_marker( "Overmap specials" ), &overmap_specials::finalize,
+                { "Overmap terrain", "Overmap connections" }, true
+            },
+            { translate_marker( "Overmap locations" ), &overmap_locations::finalize },
+            { translate_marker( "Cities" ), &city::finalize },
+            { translate_marker( "Math functions" ), &jmath_func::finalize },
+            { translate_marker( "Start locations" ), &start_locations::finalize_all },
+            { translate_marker( "Vehicle part migrations" ), &vpart_migration::finalize },
+            { translate_marker( "Vehicle prototypes" ), &vehicles::finalize_prototypes },
+            { translate_marker( "Mapgen weights" ), &calculate_mapgen_weights },
+            {
+                translate_marker( "Mapgen parameters" ),
+                &overmap_specials::finalize_mapgen_parameters,
+                { "Overmap specials" }
+            },
+            { translate_marker( "Behaviors" ), &behavior::finalize },
             {
-                _( "Monster types" ), []()
+                translate_marker( "Monster types" ), []()
                 {
                     set_mon_flag_ids();
                     MonsterGenerator::generator().finalize_mtypes();
                 }
             },
-            { _( "Monster groups" ), &MonsterGroupManager::FinalizeMonsterGroups },
-            { _( "Monster factions" ), &monfactions::finalize },
-            { _( "Factions" ), &npc_factions::finalize },
-            { _( "Move modes" ), &move_mode::finalize },
-            { _( "Constructions" ), &finalize_constructions },
-            { _( "Crafting recipes" ), &recipe_dictionary::finalize },
-            { _( "Recipe groups" ), &recipe_group::check },
-            { _( "Martial arts" ), &finalize_martial_arts },
-            { _( "Scenarios" ), &scenario::finalize },
-            { _( "Climbing aids" ), &climbing_aid::finalize },
-            { _( "NPC classes" ), &npc_class::finalize_all },
-            { _( "Missions" ), &mission_type::finalize },
-            { _( "Harvest lists" ), &harvest_list::finalize_all },
-            { _( "Anatomies" ), &anatomy::finalize_all },
-            { _( "Mutations" ), &mutation_branch::finalize_all },
-            { _( "Achievements" ), &achievement::finalize },
-            { _( "Damage info orders" ), &damage_info_order::finalize_all },
-            { _( "Widgets" ), &widget::finalize },
-            { _( "Faults" ), &faults::finalize },
+            { translate_marker( "Monster groups" ), &MonsterGroupManager::FinalizeMonsterGroups },
+            { translate_marker( "Monster factions" ), &monfactions::finalize },
+            { translate_marker( "Factions" ), &npc_factions::finalize },
+            { translate_marker( "Move modes" ), &move_mode::finalize },
+            { translate_marker( "Constructions" ), &finalize_constructions },
+            { translate_marker( "Crafting recipes" ), &recipe_dictionary::finalize },
+            { translate_marker( "Recipe groups" ), &recipe_group::check },
+            { translate_marker( "Martial arts" ), &finalize_martial_arts },
+            {
+                translate_marker( "Attack vectors" ), &finalize_attack_vectors,
+                { "Body parts", "Sub body parts" }, true
+            },
+            { translate_marker( "Scenarios" ), &scenario::finalize },
+            { translate_marker( "Climbing aids" ), &climbing_aid::finalize },
+            { translate_marker( "NPC classes" ), &npc_class::finalize_all },
+            { translate_marker( "Missions" ), &mission_type::finalize },
+            { translate_marker( "Harvest lists" ), &harvest_list::finalize_all },
+            { translate_marker( "Anatomies" ), &anatomy::finalize_all },
+            { translate_marker( "Mutations" ), &mutation_branch::finalize_all },
+            { translate_marker( "Achievements" ), &achievement::finalize },
+            { translate_marker( "Damage info orders" ), &damage_info_order::finalize_all },
+            { translate_marker( "Widgets" ), &widget::finalize },
+            { translate_marker( "Faults" ), &faults::finalize },
 #if defined(TILES)
-            { _( "Tileset" ), &load_tileset },
+            { translate_marker( "Tileset" ), &load_tileset },
 #endif
-            { _( "Math expressions" ), &finalize_conditions },
+            { translate_marker( "Math expressions" ), &finalize_conditions },
         }
     };
 
-    for( const named_entry &e : entries ) {
-        loading_ui::show( _( "Finalizing" ), e.first );
-        e.second();
-        check_sigint();
-    }
+    run_loading_stages( _( "Finalizing" ), stages );
 
     if( !get_option<bool>( "SKIP_VERIFICATION" ) ) {
         check_consistency();
@@ -874,101 +1054,136 @@ void DynamicDataLoader::finalize_loaded_data()
 
 void DynamicDataLoader::check_consistency()
 {
-    using named_entry = std::pair<std::string, std::function<void()>>;
-    const std::vector<named_entry> entries = {{
-            { _( "Flags" ), &json_flag::check_consistency },
-            { _( "Option sliders" ), &option_slider::check_consistency },
+    const std::vector<loading_stage> stages = {{
+            { translate_marker( "Flags" ), &json_flag::check_consistency, {}, true },
+            { translate_marker( "Option sliders" ), &option_slider::check_consistency, {}, true },
             {
-                _( "Crafting requirements" ), []()
+                translate_marker( "Crafting requirements" ), []()
                 {
                     requirement_data::check_consistency();
                 }
             },
-            { _( "Vitamins" ), &vitamin::check_consistency },
-            { _( "Weather types" ), &weather_types::check_consistency },
-            { _( "Weapon categories" ), &weapon_category::verify_weapon_categories },
-            { _( "Effect on conditions" ), &effect_on_conditions::check_consistency },
-            { _( "Field types" ), &field_types::check_consistency },
-            { _( "Field type migrations" ), &field_type_migrations::check },
-            { _( "Ammo effects" ), &ammo_effects::check_consistency },
-            { _( "Emissions" ), &emit::check_consistency },
-            { _( "Effect types" ), &effect_type::check_consistency },
-            { _( "Activities" ), &activity_type::check_consistency },
-            { _( "Addiction types" ), &add_type::check_add_types },
+            { translate_marker( "Vitamins" ), &vitamin::check_consistency, {}, true },
+            { translate_marker( "Weather types" ), &weather_types::check_consistency, {}, true },
+            {
+                translate_marker( "Weapon categories" ), &weapon_category::verify_weapon_categories,
+                {}, true
+            },
             {
-                _( "Items" ), []()
+                translate_marker( "Effect on conditions" ), &effect_on_conditions::check_consistency
+            },
+            { translate_marker( "Field types" ), &field_types::check_consistency, {}, true },
+            {
+                translate_marker( "Field type migrations" ), &field_type_migrations::check,
+                { "Field types" }
+            },
+            { translate_marker( "Ammo effects" ), &ammo_effects::check_consistency, {}, true },
+            { translate_marker( "Emissions" ), &emit::check_consistency, {}, true },
+            { translate_marker( "Effect types" ), &effect_type::check_consistency, {}, true },
+            { translate_marker( "Activities" ), &activity_type::check_consistency, {}, true },
+            { translate_marker( "Addiction types" ), &add_type::check_add_types, {}, true },
+            {
+                translate_marker( "Items" ), []()
                 {
                     item_controller->check_definitions();
                 }
             },
-            { _( "Materials" ), &materials::check },
-            { _( "Faults" ), &faults::check_consistency },
-            { _( "Vehicle parts" ), &vehicles::parts::check },
-            { _( "Vehicle part migrations" ), &vpart_migration::check },
-            { _( "Mapgen definitions" ), &check_mapgen_definitions },
-            { _( "Mapgen palettes" ), &mapgen_palette::check_definitions },
+            { translate_marker( "Materials" ), &materials::check, {}, true },
+            { translate_marker( "Faults" ), &faults::check_consistency, {}, true },
+            { translate_marker( "Vehicle parts" ), &vehicles::parts::check },
             {
-                _( "Monster types" ), []()
+                translate_marker( "Vehicle part migrations" ), &vpart_migration::check,
+                { "Vehicle parts" }
+            },
+            { translate_marker( "Mapgen definitions" ), &check_mapgen_definitions },
+            { translate_marker( "Mapgen palettes" ), &mapgen_palette::check_definitions },
+            {
+                translate_marker( "Monster types" ), []()
                 {
                     MonsterGenerator::generator().check_monster_definitions();
                 }
             },
-            { _( "Monster groups" ), &MonsterGroupManager::check_group_definitions },
-            { _( "Furniture and terrain" ), &check_furniture_and_terrain },
-            { _( "Furniture and terrain migrations" ), &ter_furn_migrations::check },
-            { _( "Constructions" ), &check_constructions },
-            { _( "Crafting recipes" ), &recipe_dictionary::check_consistency },
-            { _( "Professions" ), &profession::check_definitions },
-            { _( "Profession groups" ), &profession_group::check_profession_group_consistency },
-            { _( "Martial arts" ), &check_martialarts },
-            { _( "Climbing aid" ), &climbing_aid::check_consistency },
-            { _( "Mutations" ), &mutation_branch::check_consistency },
-            { _( "Mutation categories" ), &mutation_category_trait::check_consistency },
-            { _( "Region settings" ), check_region_settings },
-            { _( "Overmap land use codes" ), &overmap_land_use_codes::check_consistency },
-            { _( "Overmap connections" ), &overmap_connections::check_consistency },
-            { _( "Overmap terrain" ), &overmap_terrains::check_consistency },
-            { _( "Overmap terrain vision" ), &oter_vision::check_oter_vision },
-            { _( "Overmap locations" ), &overmap_locations::check_consistency },
-            { _( "Cities" ), &city::check_consistency },
-            { _( "Overmap specials" ), &overmap_specials::check_consistency },
-            { _( "Map extras" ), &MapExtras::check_consistency },
-            { _( "Shop rates" ), &shopkeeper_cons_rates::check_all },
-            { _( "Start locations" ), &start_locations::check_consistency },
-            { _( "Ammunition types" ), &ammunition_type::check_consistency },
-            { _( "Traps" ), &trap::check_consistency },
-            { _( "Trap migrations" ), &trap_migrations::check },
-            { _( "Bionics" ), &bionic_data::check_bionic_consistency },
-            { _( "Gates" ), &gates::check },
-            { _( "NPC classes" ), &npc_class::check_consistency },
-            { _( "Behaviors" ), &behavior::check_consistency },
-            { _( "Mission types" ), &mission_type::check_consistency },
+            { translate_marker( "Monster groups" ), &MonsterGroupManager::check_group_definitions },
+            { translate_marker( "Furniture and terrain" ), &check_furniture_and_terrain },
+            {
+                translate_marker( "Furniture and terrain migrations" ), &ter_furn_migrations::check,
+                { "Furniture and terrain" }
+            },
+            { translate_marker( "Constructions" ), &check_constructions },
+            { translate_marker( "Crafting recipes" ), &recipe_dictionary::check_consistency },
+            { translate_marker( "Professions" ), &profession::check_definitions },
+            {
+                translate_marker( "Profession groups" ),
+                &profession_group::check_profession_group_consistency,
+                { "Professions" }
+            },
+            { translate_marker( "Martial arts" ), &check_martialarts },
+            { translate_marker( "Climbing aid" ), &climbing_aid::check_consistency, {}, true },
+            { translate_marker( "Mutations" ), &mutation_branch::check_consistency },
+            {
+                translate_marker( "Mutation categories" ),
+                &mutation_category_trait::check_consistency,
+                { "Mutations" }, true
+            },
+            { translate_marker( "Region settings" ), check_region_settings },
+            {
+                translate_marker( "Overmap land use codes" ),
+                &overmap_land_use_codes::check_consistency, {}, true
+            },
+            { translate_marker( "Overmap connections" ), &overmap_connections::check_consistency },
+            { translate_marker( "Overmap terrain" ), &overmap_terrains::check_consistency },
+            { translate_marker( "Overmap terrain vision" ), &oter_vision::check_oter_vision },
+            {
+                translate_marker( "Overmap locations" ), &overmap_locations::check_consistency,
+                {}, true
+            },
+            { translate_marker( "Cities" ), &city::check_consistency, {}, true },
+            { translate_marker( "Overmap specials" ), &overmap_specials::check_consistency },
+            { translate_marker( "Map extras" ), &MapExtras::check_consistency },
+            { translate_marker( "Shop rates" ), &shopkeeper_cons_rates::check_all, {}, true },
+            { translate_marker( "Start locations" ), &start_locations::check_consistency },
+            {
+                translate_marker( "Ammunition types" ), &ammunition_type::check_consistency,
+                {}, true
+            },
+            { translate_marker( "Traps" ), &trap::check_consistency },
+            { translate_marker( "Trap migrations" ), &trap_migrations::check, { "Traps" } },
+            { translate_marker( "Bionics" ), &bionic_data::check_bionic_consistency },
+            { translate_marker( "Gates" ), &gates::check, {}, true },
+            { translate_marker( "NPC classes" ), &npc_class::check_consistency },
+            { translate_marker( "Behaviors" ), &behavior::check_consistency, {}, true },
+            { translate_marker( "Mission types" ), &mission_type::check_consistency },
             {
-                _( "Item actions" ), []()
+                translate_marker( "Item actions" ), []()
                 {
                     item_action_generator::generator().check_consistency();
                 }
             },
-            { _( "Harvest lists" ), &harvest_list::check_consistency },
-            { _( "NPC templates" ), &npc_template::check_consistency },
-            { _( "Body parts" ), &body_part_type::check_consistency },
-            { _( "Body graphs" ), &bodygraph::check_all },
-            { _( "Anatomies" ), &anatomy::check_consistency },
-            { _( "Spells" ), &spell_type::check_consistency },
-            { _( "Transformations" ), &event_transformation::check_consistency },
-            { _( "Statistics" ), &event_statistic::check_consistency },
-            { _( "Scent types" ), &scent_type::check_scent_consistency },
-            { _( "Scores" ), &score::check_consistency },
-            { _( "Achievements" ), &achievement::check_consistency },
-            { _( "Disease types" ), &disease_type::check_disease_consistency },
-            { _( "Factions" ), &faction_template::check_consistency },
-            { _( "Damage types" ), &damage_type::check }
+            { translate_marker( "Harvest lists" ), &harvest_list::check_consistency, {}, true },
+            { translate_marker( "NPC templates" ), &npc_template::check_consistency },
+            { translate_marker( "Body parts" ), &body_part_type::check_consistency, {}, true },
+            { translate_marker( "Body graphs" ), &bodygraph::check_all, { "Body parts" }, true },
+            {
+                translate_marker( "Anatomies" ), &anatomy::check_consistency,
+                { "Body parts" }, true
+            },
+            { translate_marker( "Spells" ), &spell_type::check_consistency },
+            { translate_marker( "Transformations" ), &event_transformation::check_consistency },
+            {
+                translate_marker( "Statistics" ), &event_statistic::check_consistency,
+                { "Transformations" }
+            },
+            { translate_marker( "Scent types" ), &scent_type::check_scent_consistency, {}, true },
+            { translate_marker( "Scores" ), &score::check_consistency, { "Statistics" } },
+            { translate_marker( "Achievements" ), &achievement::check_consistency, { "Scores" } },
+            {
+                translate_marker( "Disease types" ), &disease_type::check_disease_consistency,
+                {}, true
+            },
+            { translate_marker( "Factions" ), &faction_template::check_consistency, {}, true },
+            { translate_marker( "Damage types" ), &damage_type::check, {}, true }
         }
     };
 
-    for( const named_entry &e : entries ) {
-        loading_ui::show( _( "Verifying" ), e.first );
-        e.second();
-        check_sigint();
-    }
+    run_loading_stages( _( "Verifying" ), stages );
 }
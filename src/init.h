@@ -100,6 +100,13 @@ class DynamicDataLoader
          */
         void load_all_from_json( const JsonValue &jsin, const std::string &src,
                                  const cata_path &base_path, const cata_path &full_path );
+        /**
+         * Parses files, all found below base_path, and loads them in order through
+         * @ref load_all_from_json.
+         * @throws std::exception on all kind of errors.
+         */
+        void load_files_from_path( const std::vector<cata_path> &files, const std::string &src,
+                                   const cata_path &base_path );
         /**
          * Load a single object from a json object.
          * @param jo The json object to load the C++-object from.
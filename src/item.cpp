@@ -1722,7 +1722,7 @@ stacking_info item::stacks_with( const item &rhs, bool check_components, bool co
     // Guns that differ only by dirt/shot_counter can still stack,
     // but other item_vars such as label/note will prevent stacking
     static const std::set<std::string> ignore_keys = { "dirt", "shot_counter", "spawn_location_omt", "ethereal", "last_act_by_char_id" };
-    bits.set( tname::segments::VARS, map_equal_ignoring_keys( item_vars, rhs.item_vars, ignore_keys ) );
+    bits.set( tname::segments::VARS, item_vars.equal_ignoring( rhs.item_vars, ignore_keys ) );
     bits.set( tname::segments::ETHEREAL, _stacks_ethereal( *this, rhs ) );
     bits.set( tname::segments::LOCATION_HINT, _stacks_location_hint( *this, rhs ) );
 
@@ -1831,41 +1831,38 @@ void item::force_insert_item( const item &it, pocket_type pk_type )
 
 void item::set_var( const std::string &name, const int value )
 {
-    std::ostringstream tmpstream;
-    tmpstream.imbue( std::locale::classic() );
-    tmpstream << value;
-    item_vars[name] = tmpstream.str();
+    item_vars.set( name, static_cast<long long>( value ) );
 }
 
 void item::set_var( const std::string &name, const long long value )
 {
-    std::ostringstream tmpstream;
-    tmpstream.imbue( std::locale::classic() );
-    tmpstream << value;
-    item_vars[name] = tmpstream.str();
+    item_vars.set( name, value );
 }
 
 // NOLINTNEXTLINE(cata-no-long)
 void item::set_var( const std::string &name, const long value )
 {
-    std::ostringstream tmpstream;
-    tmpstream.imbue( std::locale::classic() );
-    tmpstream << value;
-    item_vars[name] = tmpstream.str();
+    item_vars.set( name, static_cast<long long>( value ) );
 }
 
 void item::set_var( const std::string &name, const double value )
 {
-    item_vars[name] = string_format( "%f", value );
+    item_vars.set( name, value );
 }
 
 double item::get_var( const std::string &name, const double default_value ) const
 {
-    const auto it = item_vars.find( name );
-    if( it == item_vars.end() ) {
+    const item_var_map::var_value *var = item_vars.find( name );
+    if( var == nullptr ) {
         return default_value;
     }
-    const std::string &val = it->second;
+    if( const long long *i = std::get_if<long long>( var ) ) {
+        return static_cast<double>( *i );
+    }
+    if( const double *d = std::get_if<double>( var ) ) {
+        return *d;
+    }
+    const std::string &val = std::get<std::string>( *var );
     char *end;
     errno = 0;
     double result = strtod( val.data(), &end );
@@ -1898,24 +1895,25 @@ double item::get_var( const std::string &name, const double default_value ) cons
 
 void item::set_var( const std::string &name, const tripoint_abs_omt &value )
 {
-    item_vars[name] = value.to_string();
+    item_vars.set( name, value.to_string() );
 }
 
 tripoint_abs_omt item::get_var( const std::string &name,
                                 const tripoint_abs_omt &default_value ) const
 {
-    const auto it = item_vars.find( name );
-    if( it == item_vars.end() ) {
+    const item_var_map::var_value *var = item_vars.find( name );
+    if( var == nullptr ) {
         return default_value;
     }
+    const std::string val = item_var_map::to_string( *var );
 
     // todo: has to read both "(0,0,0)" and "0,0,0" formats for now, clean up after 0.I
     // first is produced by tripoint::to_string, second was old custom format
-    if( it->second[0] == '(' ) {
-        return tripoint_abs_omt{tripoint::from_string( it->second )};
+    if( val[0] == '(' ) {
+        return tripoint_abs_omt{tripoint::from_string( val )};
     }
 
-    std::vector<std::string> values = string_split( it->second, ',' );
+    std::vector<std::string> values = string_split( val, ',' );
     cata_assert( values.size() == 3 );
     auto convert_or_error = []( const std::string_view s ) {
         ret_val<int> result = try_parse_integer<int>( s, false );
@@ -1933,16 +1931,16 @@ tripoint_abs_omt item::get_var( const std::string &name,
 
 void item::set_var( const std::string &name, const std::string &value )
 {
-    item_vars[name] = value;
+    item_vars.set( name, value );
 }
 
 std::string item::get_var( const std::string &name, const std::string &default_value ) const
 {
-    const auto it = item_vars.find( name );
-    if( it == item_vars.end() ) {
+    const item_var_map::var_value *var = item_vars.find( name );
+    if( var == nullptr ) {
         return default_value;
     }
-    return it->second;
+    return item_var_map::to_string( *var );
 }
 
 std::string item::get_var( const std::string &name ) const
@@ -1952,13 +1950,14 @@ std::string item::get_var( const std::string &name ) const
 
 std::optional<std::string> item::maybe_get_var( const std::string &name ) const
 {
-    const auto it = item_vars.find( name );
-    return it == item_vars.end() ? std::nullopt : std::optional<std::string> { it->second };
+    const item_var_map::var_value *var = item_vars.find( name );
+    return var == nullptr ? std::nullopt :
+           std::optional<std::string> { item_var_map::to_string( *var ) };
 }
 
 bool item::has_var( const std::string &name ) const
 {
-    return item_vars.count( name ) > 0;
+    return item_vars.contains( name );
 }
 
 void item::erase_var( const std::string &name )
@@ -2455,8 +2454,7 @@ void item::basic_info( std::vector<iteminfo> &info, const iteminfo_query *parts,
 
     if( parts->test( iteminfo_parts::DESCRIPTION ) ) {
         insert_separation_line( info );
-        const std::map<std::string, std::string>::const_iterator idescription =
-            item_vars.find( "description" );
+        const std::optional<std::string> idescription = maybe_get_var( "description" );
         const std::optional<translation> snippet = SNIPPET.get_snippet_by_id( snip_id );
         if( snippet.has_value() ) {
             // Just use the dynamic description
@@ -2475,8 +2473,8 @@ void item::basic_info( std::vector<iteminfo> &info, const iteminfo_query *parts,
                 //note that you have seen the snippet
                 get_avatar().add_snippet( snip_id );
             }
-        } else if( idescription != item_vars.end() ) {
-            info.emplace_back( "DESCRIPTION", idescription->second );
+        } else if( idescription ) {
+            info.emplace_back( "DESCRIPTION", *idescription );
         } else if( has_itype_variant() ) {
             info.emplace_back( "DESCRIPTION", variant_description() );
         } else {
@@ -2590,11 +2588,12 @@ void item::debug_info( std::vector<iteminfo> &info, const iteminfo_query *parts,
             }, enumeration_conjunction::none );
 
             info.emplace_back( "BASE", string_format( _( "flags: %s" ), flags_listed ) );
-            for( auto const &imap : item_vars ) {
+            item_vars.for_each( [&info]( const std::string & name,
+            const item_var_map::var_value & value ) {
                 info.emplace_back( "BASE",
-                                   string_format( _( "item var: %s, %s" ), imap.first,
-                                                  imap.second ) );
-            }
+                                   string_format( _( "item var: %s, %s" ), name,
+                                                  item_var_map::to_string( value ) ) );
+            } );
 
             info.emplace_back( "BASE", _( "wetness: " ),
                                "", iteminfo::lower_is_better,
@@ -6038,27 +6037,26 @@ void item::final_info( std::vector<iteminfo> &info, const iteminfo_query *parts,
         }
     }
 
-    std::map<std::string, std::string>::const_iterator item_note = item_vars.find( "item_note" );
+    const std::optional<std::string> item_note = maybe_get_var( "item_note" );
 
-    if( item_note != item_vars.end() && parts->test( iteminfo_parts::DESCRIPTION_NOTES ) ) {
+    if( item_note && parts->test( iteminfo_parts::DESCRIPTION_NOTES ) ) {
         insert_separation_line( info );
         std::string ntext;
-        std::map<std::string, std::string>::const_iterator item_note_tool =
-            item_vars.find( "item_note_tool" );
+        const std::optional<std::string> item_note_tool = maybe_get_var( "item_note_tool" );
         const use_function *use_func =
-            item_note_tool != item_vars.end() ?
+            item_note_tool ?
             item_controller->find_template(
-                itype_id( item_note_tool->second ) )->get_use( "inscribe" ) :
+                itype_id( *item_note_tool ) )->get_use( "inscribe" ) :
             nullptr;
         const inscribe_actor *use_actor =
             use_func ? dynamic_cast<const inscribe_actor *>( use_func->get_actor_ptr() ) : nullptr;
         if( use_actor ) {
             //~ %1$s: gerund (e.g. carved), %2$s: item name, %3$s: inscription text
             ntext = string_format( pgettext( "carving", "%1$s on the %2$s is: %3$s" ),
-                                   use_actor->gerund, tname(), item_note->second );
+                                   use_actor->gerund, tname(), *item_note );
         } else {
             //~ %1$s: inscription text
-            ntext = string_format( pgettext( "carving", "Note: %1$s" ), item_note->second );
+            ntext = string_format( pgettext( "carving", "Note: %1$s" ), *item_note );
         }
         info.emplace_back( "DESCRIPTION", ntext );
     }
@@ -6913,7 +6911,7 @@ std::string item::tname( unsigned int quantity, tname::segment_bitset const &seg
         ret += tname::print_segment( idx, *this, quantity, segments );
     }
 
-    if( item_vars.find( "item_note" ) != item_vars.end() ) {
+    if( item_vars.contains( "item_note" ) ) {
         //~ %s is an item name. This style is used to denote items with notes.
         return string_format( _( "*%s*" ), ret );
     }
@@ -8070,7 +8068,16 @@ void item::calc_rot( units::temperature temp, const float spoil_modifier,
         return;
     }
 
-    // rot modifier
+    if( has_own_flag( flag_COLD ) ) {
+        temp = std::min( temperatures::fridge, temp );
+    }
+
+    rot += rot_factor( spoil_modifier ) * time_delta / 1_seconds *
+           calc_hourly_rotpoints_at_temp( temp ) * 1_turns / ( 1_hours / 1_seconds );
+}
+
+float item::rot_factor( const float spoil_modifier ) const
+{
     float factor = spoil_modifier;
     if( is_corpse() && has_flag( flag_FIELD_DRESS ) ) {
         factor *= 0.75;
@@ -8087,13 +8094,7 @@ void item::calc_rot( units::temperature temp, const float spoil_modifier,
     if( has_own_flag( flag_IRRADIATED ) ) {
         factor *= 0.25;
     }
-
-    if( has_own_flag( flag_COLD ) ) {
-        temp = std::min( temperatures::fridge, temp );
-    }
-
-    rot += factor * time_delta / 1_seconds * calc_hourly_rotpoints_at_temp( temp ) * 1_turns /
-           ( 1_hours / 1_seconds );
+    return factor;
 }
 
 void item::calc_rot_while_processing( time_duration processing_duration )
@@ -12944,20 +12945,20 @@ bool item_compare_by_charges( const item &left, const item &right )
 static const std::string USED_BY_IDS( "USED_BY_IDS" );
 bool item::already_used_by_player( const Character &p ) const
 {
-    const auto it = item_vars.find( USED_BY_IDS );
-    if( it == item_vars.end() ) {
+    const item_var_map::var_value *used_by_ids = item_vars.find( USED_BY_IDS );
+    if( used_by_ids == nullptr ) {
         return false;
     }
     // USED_BY_IDS always starts *and* ends with a ';', the search string
     // ';<id>;' matches at most one part of USED_BY_IDS, and only when exactly that
     // id has been added.
     const std::string needle = string_format( ";%d;", p.getID().get_value() );
-    return it->second.find( needle ) != std::string::npos;
+    return item_var_map::to_string( *used_by_ids ).find( needle ) != std::string::npos;
 }
 
 void item::mark_as_used_by_player( const Character &p )
 {
-    std::string &used_by_ids = item_vars[ USED_BY_IDS ];
+    std::string &used_by_ids = item_vars.string_value( USED_BY_IDS );
     if( used_by_ids.empty() ) {
         // *always* start with a ';'
         used_by_ids = ";";
@@ -13052,24 +13053,14 @@ void item::apply_freezerburn()
 bool item::process_temperature_rot( float insulation, const tripoint_bub_ms &pos, map &here,
                                     Character *carrier, const temperature_flag flag, float spoil_modifier, bool watertight_container )
 {
-    const time_point now = calendar::turn;
-
-    // if player debug menu'd the time backward it breaks stuff, just reset the
-    // last_temp_check in this case
-    if( now - last_temp_check < 0_turns ) {
-        reset_temp_check();
-        return false;
-    }
-
-    // process temperature and rot at most once every 100_turns (10 min)
-    // note we're also gated by item::processing_speed
-    time_duration smallest_interval = 10_minutes;
-    if( now - last_temp_check < smallest_interval && units::to_joule_per_gram( specific_energy ) > 0 ) {
-        return false;
-    }
-
-    units::temperature temp = get_weather().get_temperature( pos.raw() );
+    return advance_to( calendar::turn, insulation, pos, here, carrier, flag, spoil_modifier,
+                       watertight_container );
+}
 
+// The temperature something stored this way is kept at, when the surroundings are at temp.
+static units::temperature stored_temperature( units::temperature temp,
+        const temperature_flag flag )
+{
     switch( flag ) {
         case temperature_flag::NORMAL:
             // Just use the temperature normally
@@ -13089,6 +13080,28 @@ bool item::process_temperature_rot( float insulation, const tripoint_bub_ms &pos
         default:
             debugmsg( "Temperature flag enum not valid.  Using current temperature." );
     }
+    return temp;
+}
+
+bool item::advance_to( const time_point &now, float insulation, const tripoint_bub_ms &pos,
+                       map &here, Character *carrier, const temperature_flag flag, float spoil_modifier,
+                       bool watertight_container )
+{
+    // if player debug menu'd the time backward it breaks stuff, just reset the
+    // last_temp_check in this case
+    if( now - last_temp_check < 0_turns ) {
+        reset_temp_check();
+        return false;
+    }
+
+    // process temperature and rot at most once every 100_turns (10 min)
+    // note we're also gated by item::processing_speed
+    time_duration smallest_interval = 10_minutes;
+    if( now - last_temp_check < smallest_interval && units::to_joule_per_gram( specific_energy ) > 0 ) {
+        return false;
+    }
+
+    units::temperature temp = stored_temperature( get_weather().get_temperature( pos.raw() ), flag );
 
     bool carried = carrier != nullptr;
     // body heat increases inventory temperature by 5 F (2.77 K) and insulation by 50%
@@ -13139,27 +13152,7 @@ bool item::process_temperature_rot( float insulation, const tripoint_bub_ms &pos
             } else {
                 env_temperature = AVERAGE_ANNUAL_TEMPERATURE;
             }
-            env_temperature += temp_mod;
-
-            switch( flag ) {
-                case temperature_flag::NORMAL:
-                    // Just use the temperature normally
-                    break;
-                case temperature_flag::FRIDGE:
-                    env_temperature = std::min( env_temperature, temperatures::fridge );
-                    break;
-                case temperature_flag::FREEZER:
-                    env_temperature = std::min( env_temperature, temperatures::freezer );
-                    break;
-                case temperature_flag::HEATER:
-                    env_temperature = std::max( env_temperature, temperatures::normal );
-                    break;
-                case temperature_flag::ROOT_CELLAR:
-                    env_temperature = AVERAGE_ANNUAL_TEMPERATURE;
-                    break;
-                default:
-                    debugmsg( "Temperature flag enum not valid.  Using normal temperature." );
-            }
+            env_temperature = stored_temperature( env_temperature + temp_mod, flag );
 
             // Calculate item temperature from environment temperature
             // If the time was more than 2 d ago we do not care about item temperature.
@@ -13209,6 +13202,84 @@ bool item::process_temperature_rot( float insulation, const tripoint_bub_ms &pos
     return false;
 }
 
+time_point item::next_state_change( const tripoint_bub_ms &pos, const float insulation,
+                                    const temperature_flag flag, const float spoil_modifier ) const
+{
+    const time_point soon = calendar::turn + time_duration::from_turns( processing_speed() );
+    // Everything else an active item does when it is processed has to happen on time.
+    if( !active || !is_comestible() || ethereal || wetness > 0 || has_link_data() || is_relic() ||
+        requires_tags_processing || !type->emits.empty() || has_flag( flag_DECAYS_IN_AIR ) ||
+        units::to_joule_per_gram( specific_energy ) < 0 || last_temp_check > calendar::turn ) {
+        return soon;
+    }
+    // The surroundings are only looked at when the item is processed, and the weather changes
+    // by the hour.
+    const float max_turns = to_turns<float>( 1_hours );
+    time_point next = std::min( last_temp_check + 1_hours, countdown_point );
+    const auto after_turns = [&]( const float turns ) {
+        return last_temp_check + time_duration::from_turns( static_cast<int>( std::min( turns,
+                max_turns ) ) );
+    };
+    const units::temperature env = stored_temperature( get_weather().get_temperature( pos.raw() ),
+                                   flag );
+
+    if( goes_bad() && spoil_modifier != 0 ) {
+        // As fast as calc_rot could make it go, e.g. ignoring that frozen items don't rot.
+        const float rot_per_hour = rot_factor( spoil_modifier ) * calc_hourly_rotpoints_at_temp( env );
+        if( rot_per_hour > 0 ) {
+            // Fresh, going bad, rotten and rotten away.
+            for( const double relative_rot : { 0.1, 0.9, 1.0, 2.0 } ) {
+                const time_duration left = get_shelf_life() * relative_rot - rot;
+                if( left > 0_turns ) {
+                    next = std::min( next, after_turns( to_turns<float>( left ) *
+                                                        to_turns<float>( 1_hours ) / rot_per_hour ) );
+                    break;
+                }
+            }
+        }
+    }
+
+    const float item_temperature = units::to_kelvin( temperature );
+    const float env_temperature = units::to_kelvin( env );
+    // calc_temp leaves the item alone this close to the temperature around it.
+    if( std::abs( env_temperature - item_temperature ) < 0.4 ) {
+        return std::max( next, soon );
+    }
+    const float freezing_temperature = units::to_kelvin( get_freeze_point() );
+    const float frozen_energy = get_specific_heat_solid() * freezing_temperature;
+    const float energy = units::to_joule_per_gram( specific_energy );
+    float specific_heat;
+    if( energy < frozen_energy ) {
+        specific_heat = get_specific_heat_solid();
+    } else if( energy > frozen_energy + get_latent_heat() ) {
+        specific_heat = get_specific_heat_liquid();
+    } else {
+        // Melting or freezing.
+        return soon;
+    }
+    // The item approaches the temperature around it exponentially, see calc_temp.  Find when it
+    // gets to the first temperature that changes its flags or phase.
+    const float turns_per_e_fold = to_gram( weight() ) * specific_heat /
+                                   heat_transfer_rate( insulation );
+    for( const units::temperature &threshold : {
+             temperatures::cold, temperatures::hot, temperatures::boiling, get_freeze_point()
+         } ) {
+        const float threshold_temperature = units::to_kelvin( threshold );
+        if( ( item_temperature - threshold_temperature ) * ( env_temperature - threshold_temperature ) <
+            0 ) {
+            const float turns = turns_per_e_fold * std::log( ( item_temperature - env_temperature ) /
+                                ( threshold_temperature - env_temperature ) );
+            next = std::min( next, after_turns( turns ) );
+        }
+    }
+    return std::max( next, soon );
+}
+
+float item::heat_transfer_rate( const float insulation ) const
+{
+    return 0.0076 * std::pow( to_milliliter( volume() ), 2.0 / 3.0 ) / insulation;
+}
+
 void item::calc_temp( const units::temperature &temp, const float insulation,
                       const time_duration &time_delta )
 {
@@ -13230,8 +13301,7 @@ void item::calc_temp( const units::temperature &temp, const float insulation,
 
     // specific_energy = item thermal energy (J/g). Stored in the item
     // temperature = item temperature (K). Stored in the item
-    const float conductivity_term = 0.0076 * std::pow( to_milliliter( volume() ),
-                                    2.0 / 3.0 ) / insulation;
+    const float conductivity_term = heat_transfer_rate( insulation );
     const float specific_heat_liquid = get_specific_heat_liquid();
     const float specific_heat_solid = get_specific_heat_solid();
     const float latent_heat = get_latent_heat();
@@ -14927,7 +14997,7 @@ bool item::is_reloadable() const
 std::string item::type_name( unsigned int quantity, bool use_variant, bool use_cond_name,
                              bool use_corpse ) const
 {
-    const auto iter = item_vars.find( "name" );
+    const item_var_map::var_value *name_var = item_vars.find( "name" );
     std::string ret_name;
     if( typeId() == itype_blood ) {
         if( corpse == nullptr || corpse->id.is_null() ) {
@@ -14937,8 +15007,8 @@ std::string item::type_name( unsigned int quantity, bool use_variant, bool use_c
                                              "%s blood",  quantity ),
                                   corpse->nname() );
         }
-    } else if( iter != item_vars.end() ) {
-        return iter->second;
+    } else if( name_var != nullptr ) {
+        return item_var_map::to_string( *name_var );
     } else if( use_variant && has_itype_variant() ) {
         ret_name = itype_variant().alt_name.translated( quantity );
     } else {
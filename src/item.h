@@ -27,6 +27,7 @@
 #include "item_contents.h"
 #include "item_location.h"
 #include "item_tname.h"
+#include "item_var_map.h"
 #include "material.h"
 #include "requirements.h"
 #include "safe_reference.h"
@@ -1074,6 +1075,28 @@ class item : public visitable
                                       temperature_flag flag = temperature_flag::NORMAL, float spoil_modifier = 1.0f,
                                       bool watertight_container = false );
 
+        /**
+         * Brings the temperature, rot and air exposure of the item from its last temperature check
+         * up to the given time, as process_temperature_rot does for the current turn.  Hours that
+         * have passed are worked out from the weather of that time, the rest from the current
+         * temperature around the item.
+         * @return true if the item is fully rotten and is ready to be removed
+         */
+        bool advance_to( const time_point &now, float insulation, const tripoint_bub_ms &pos,
+                         map &here, Character *carrier, temperature_flag flag = temperature_flag::NORMAL,
+                         float spoil_modifier = 1.0f, bool watertight_container = false );
+
+        /**
+         * The latest time this active food can be processed next without missing it turning
+         * rotten, rotting away, freezing, thawing or turning hot or cold, if the temperature
+         * around it stays as it is now.  At most an hour after its last temperature check, and
+         * never earlier than processing_speed() turns from now.  Items that do anything else
+         * when processed are due again after processing_speed() turns.
+         */
+        time_point next_state_change( const tripoint_bub_ms &pos, float insulation,
+                                      temperature_flag flag = temperature_flag::NORMAL,
+                                      float spoil_modifier = 1.0f ) const;
+
         /** Set the item to HOT and resets last_temp_check */
         void heat_up();
 
@@ -3068,6 +3091,10 @@ class item : public visitable
          * @param time_delta time duration from previous temperature calculation
          */
         void calc_temp( const units::temperature &temp, float insulation, const time_duration &time_delta );
+        /** Heat (J) conducted per turn and kelvin between the item and its surroundings. */
+        float heat_transfer_rate( float insulation ) const;
+        /** How much faster than normal the item rots, see calc_rot. */
+        float rot_factor( float spoil_modifier ) const;
 
         /** Calculates item specific energy (J/g) from temperature*/
         units::specific_energy get_specific_energy_from_temperature( const units::temperature
@@ -3148,7 +3175,7 @@ class item : public visitable
         cata::heap<FlagsSetType> prefix_tags_cache; // flags that will add prefixes to this item
         cata::heap<FlagsSetType> suffix_tags_cache; // flags that will add suffixes to this item
         lazy<safe_reference_anchor> anchor;
-        cata::heap<std::map<std::string, std::string>> item_vars;
+        item_var_map item_vars;
         const mtype *corpse = nullptr;
         std::string corpse_name;       // Name of the late lamented
         cata::heap<std::set<matec_id>> techniques; // item specific techniques
@@ -4387,7 +4387,9 @@ void Item_factory::load_basic_info( const JsonObject &jo, itype &def, const std:
         load_memory_card_data( *def.memory_card_data, jo.get_object( "memory_card" ) );
     }
 
-    assign( jo, "variables", def.item_variables );
+    if( jo.has_object( "variables" ) ) {
+        def.item_variables.deserialize( jo.get_object( "variables" ) );
+    }
     assign( jo, "flags", def.item_tags );
     if( jo.has_member( "source_monster" ) ) {
         assign( jo, "source_monster", def.source_monster );
@@ -4646,9 +4648,10 @@ static void apply_migration( const migration *migrant, item &obj )
 {
     if( migrant->reset_item_vars ) {
         obj.clear_vars();
-        for( const auto &pair : migrant->replace.obj().item_variables ) {
-            obj.set_var( pair.first, pair.second ) ;
-        }
+        migrant->replace.obj().item_variables.for_each( [&obj]( const std::string & name,
+        const item_var_map::var_value & value ) {
+            obj.set_var( name, item_var_map::to_string( value ) );
+        } );
     }
     for( const std::string &f : migrant->flags ) {
         obj.set_flag( flag_id( f ) );
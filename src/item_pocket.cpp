@@ -2487,116 +2487,151 @@ units::volume pocket_data::max_contains_volume() const
     return max_total_volume;
 }
 
+const item_pocket::favorite_settings::settings_values &item_pocket::favorite_settings::get() const
+{
+    static const settings_values defaults;
+    return values ? *values : defaults;
+}
+
+item_pocket::favorite_settings::settings_values &item_pocket::favorite_settings::edit()
+{
+    if( !values ) {
+        values = cata::make_value<settings_values>();
+    }
+    return *values;
+}
+
 void item_pocket::favorite_settings::clear()
 {
-    preset_name = std::nullopt;
-    priority_rating = 0;
-    item_whitelist.clear();
-    item_blacklist.clear();
-    category_whitelist.clear();
-    category_blacklist.clear();
+    if( !values ) {
+        return;
+    }
+    values->preset_name = std::nullopt;
+    values->priority_rating = 0;
+    values->item_whitelist.clear();
+    values->item_blacklist.clear();
+    values->category_whitelist.clear();
+    values->category_blacklist.clear();
 }
 
 void item_pocket::favorite_settings::set_priority( const int priority )
 {
-    priority_rating = priority;
+    if( priority != get().priority_rating ) {
+        edit().priority_rating = priority;
+    }
+}
+
+int item_pocket::favorite_settings::priority() const
+{
+    return get().priority_rating;
 }
 
 bool item_pocket::favorite_settings::is_null() const
 {
-    return item_whitelist.empty() && item_blacklist.empty() &&
-           category_whitelist.empty() && category_blacklist.empty() &&
-           priority() == 0 && !collapsed && !disabled && unload;
+    if( !values ) {
+        return true;
+    }
+    return values->item_whitelist.empty() && values->item_blacklist.empty() &&
+           values->category_whitelist.empty() && values->category_blacklist.empty() &&
+           values->priority_rating == 0 && !values->collapsed && !values->disabled && values->unload;
 }
 
 void item_pocket::favorite_settings::whitelist_item( const itype_id &id )
 {
+    settings_values &v = edit();
     // whitelisting twice removes the item from the list
-    if( item_whitelist.count( id ) ) {
-        item_whitelist.erase( id );
+    if( v.item_whitelist.count( id ) ) {
+        v.item_whitelist.erase( id );
         return;
     }
     // remove the item from the blacklist if listed
-    if( item_blacklist.count( id ) ) {
-        item_blacklist.erase( id );
+    if( v.item_blacklist.count( id ) ) {
+        v.item_blacklist.erase( id );
     }
-    item_whitelist.insert( id );
+    v.item_whitelist.insert( id );
 }
 
 void item_pocket::favorite_settings::blacklist_item( const itype_id &id )
 {
+    settings_values &v = edit();
     // blacklisting twice removes the item from the list
-    if( item_blacklist.count( id ) ) {
-        item_blacklist.erase( id );
+    if( v.item_blacklist.count( id ) ) {
+        v.item_blacklist.erase( id );
         return;
     }
     // remove the item from the whitelist if listed
-    if( item_whitelist.count( id ) ) {
-        item_whitelist.erase( id );
+    if( v.item_whitelist.count( id ) ) {
+        v.item_whitelist.erase( id );
     }
-    item_blacklist.insert( id );
+    v.item_blacklist.insert( id );
 }
 
 void item_pocket::favorite_settings::clear_item( const itype_id &id )
 {
-    item_whitelist.erase( id );
-    item_blacklist.erase( id );
+    if( values ) {
+        values->item_whitelist.erase( id );
+        values->item_blacklist.erase( id );
+    }
 }
 
 const cata::flat_set<itype_id> &item_pocket::favorite_settings::get_item_whitelist() const
 {
-    return item_whitelist;
+    return get().item_whitelist;
 }
 
 const cata::flat_set<itype_id> &item_pocket::favorite_settings::get_item_blacklist() const
 {
-    return item_blacklist;
+    return get().item_blacklist;
 }
 
 const cata::flat_set<item_category_id> &
 item_pocket::favorite_settings::get_category_whitelist() const
 {
-    return category_whitelist;
+    return get().category_whitelist;
 }
 
 const cata::flat_set<item_category_id> &
 item_pocket::favorite_settings::get_category_blacklist() const
 {
-    return category_blacklist;
+    return get().category_blacklist;
 }
 
 void item_pocket::favorite_settings::whitelist_category( const item_category_id &id )
 {
+    settings_values &v = edit();
     // whitelisting twice removes the category from the list
-    if( category_whitelist.count( id ) ) {
-        category_whitelist.erase( id );
+    if( v.category_whitelist.count( id ) ) {
+        v.category_whitelist.erase( id );
         return;
     }
     // remove the category from the blacklist if listed
-    if( category_blacklist.count( id ) ) {
-        category_blacklist.erase( id );
+    if( v.category_blacklist.count( id ) ) {
+        v.category_blacklist.erase( id );
     }
-    category_whitelist.insert( id );
+    v.category_whitelist.insert( id );
 }
 
 void item_pocket::favorite_settings::blacklist_category( const item_category_id &id )
 {
+    settings_values &v = edit();
     // blacklisting twice removes the category from the list
-    if( category_blacklist.count( id ) ) {
-        category_blacklist.erase( id );
+    if( v.category_blacklist.count( id ) ) {
+        v.category_blacklist.erase( id );
         return;
     }
     // remove the category from the whitelist if listed
-    if( category_whitelist.count( id ) ) {
-        category_whitelist.erase( id );
+    if( v.category_whitelist.count( id ) ) {
+        v.category_whitelist.erase( id );
     }
-    category_blacklist.insert( id );
+    v.category_blacklist.insert( id );
 }
 
 void item_pocket::favorite_settings::clear_category( const item_category_id &id )
 {
-    category_blacklist.erase( id );
-    category_whitelist.erase( id );
+    if( values ) {
+        values->category_blacklist.erase( id );
+        values->category_whitelist.erase( id );
+    }
 }
 
 /**
@@ -2619,28 +2654,33 @@ void item_pocket::favorite_settings::clear_category( const item_category_id &id
  */
 bool item_pocket::favorite_settings::accepts_item( const item &it ) const
 {
+    // pockets that were never configured accept everything
+    if( !values ) {
+        return true;
+    }
+    const settings_values &v = *values;
     // if this pocket is disabled it accepts nothing
-    if( disabled ) {
+    if( v.disabled ) {
         return false;
     }
     const itype_id &id = it.typeId();
-    const item_category_id &cat = category_blacklist.empty() && category_whitelist.empty()
+    const item_category_id &cat = v.category_blacklist.empty() && v.category_whitelist.empty()
                                   ? item_category_id{} :
                                   it.get_category_of_contents().id;
 
     // if the item is explicitly listed in either of the lists, then it's clear what to do with it
-    if( item_blacklist.count( id ) ) {
+    if( v.item_blacklist.count( id ) ) {
         return false;
     }
-    if( item_whitelist.count( id ) ) {
+    if( v.item_whitelist.count( id ) ) {
         return true;
     }
 
     // otherwise check the category, the same way
-    if( category_blacklist.count( cat ) ) {
+    if( v.category_blacklist.count( cat ) ) {
         return false;
     }
-    if( category_whitelist.count( cat ) ) {
+    if( v.category_whitelist.count( cat ) ) {
         return true;
     }
 
@@ -2654,10 +2694,10 @@ bool item_pocket::favorite_settings::accepts_item( const item &it ) const
     }
     // finally, if no match was found, see if there were any filters at all,
     // and either allow or deny everything that's fallen through to here.
-    if( !category_whitelist.empty() ) {
+    if( !v.category_whitelist.empty() ) {
         return false;  // we've whitelisted only some categories, and this item is not out of those.
     }
-    if( !item_whitelist.empty() && category_blacklist.empty() ) {
+    if( !v.item_whitelist.empty() && v.category_blacklist.empty() ) {
         // whitelisting only certain items, and not as a means to tweak blacklist.
         return false;
     }
@@ -2667,52 +2707,58 @@ bool item_pocket::favorite_settings::accepts_item( const item &it ) const
 
 bool item_pocket::favorite_settings::is_collapsed() const
 {
-    return collapsed;
+    return get().collapsed;
 }
 
 void item_pocket::favorite_settings::set_collapse( bool flag )
 {
-    collapsed = flag;
+    if( flag != get().collapsed ) {
+        edit().collapsed = flag;
+    }
 }
 
 bool item_pocket::favorite_settings::is_disabled() const
 {
-    return disabled;
+    return get().disabled;
 }
 
 void item_pocket::favorite_settings::set_disabled( bool flag )
 {
-    disabled = flag;
+    if( flag != get().disabled ) {
+        edit().disabled = flag;
+    }
 }
 
 bool item_pocket::favorite_settings::is_unloadable() const
 {
-    return unload;
+    return get().unload;
 }
 
 void item_pocket::favorite_settings::set_unloadable( bool flag )
 {
-    unload = flag;
+    if( flag != get().unload ) {
+        edit().unload = flag;
+    }
 }
 
 void item_pocket::favorite_settings::set_preset_name( const std::string &s )
 {
-    preset_name = s;
+    edit().preset_name = s;
 }
 
 void item_pocket::favorite_settings::set_was_edited()
 {
-    player_edited = true;
+    edit().player_edited = true;
 }
 
 bool item_pocket::favorite_settings::was_edited() const
 {
-    return player_edited;
+    return get().player_edited;
 }
 
 const std::optional<std::string> &item_pocket::favorite_settings::get_preset_name() const
 {
-    return preset_name;
+    return get().preset_name;
 }
 
 template<typename T>
@@ -2727,31 +2773,32 @@ std::string enumerate( cata::flat_set<T> container )
 
 void item_pocket::favorite_settings::info( std::vector<iteminfo> &info ) const
 {
-    if( disabled ) {
+    const settings_values &v = get();
+    if( v.disabled ) {
         info.emplace_back( "BASE", string_format(
                                _( "Items <bad>won't be inserted</bad> into this pocket unless you manually insert them." ) ) );
     }
-    if( !unload ) {
+    if( !v.unload ) {
         info.emplace_back( "BASE", string_format(
                                _( "Items in this pocket <bad>won't be unloaded</bad> unless you manually drop them." ) ) );
     }
-    if( preset_name.has_value() ) {
-        info.emplace_back( "BASE", string_format( _( "Preset Name: %s" ), preset_name.value() ) );
+    if( v.preset_name.has_value() ) {
+        info.emplace_back( "BASE", string_format( _( "Preset Name: %s" ), v.preset_name.value() ) );
     }
 
-    info.emplace_back( "BASE", string_format( "%s %d", _( "Priority:" ), priority_rating ) );
+    info.emplace_back( "BASE", string_format( "%s %d", _( "Priority:" ), v.priority_rating ) );
     info.emplace_back( "BASE", string_format( _( "Item Whitelist: %s" ),
-                       item_whitelist.empty() ? _( "(empty)" ) :
-    enumerate_as_string( item_whitelist.begin(), item_whitelist.end(), []( const itype_id & id ) {
+                       v.item_whitelist.empty() ? _( "(empty)" ) :
+    enumerate_as_string( v.item_whitelist.begin(), v.item_whitelist.end(), []( const itype_id & id ) {
         return id->nname( 1 );
     } ) ) );
     info.emplace_back( "BASE", string_format( _( "Item Blacklist: %s" ),
-                       item_blacklist.empty() ? _( "(empty)" ) :
-    enumerate_as_string( item_blacklist.begin(), item_blacklist.end(), []( const itype_id & id ) {
+                       v.item_blacklist.empty() ? _( "(empty)" ) :
+    enumerate_as_string( v.item_blacklist.begin(), v.item_blacklist.end(), []( const itype_id & id ) {
         return id->nname( 1 );
     } ) ) );
     info.emplace_back( "BASE", string_format( _( "Category Whitelist: %s" ),
-                       category_whitelist.empty() ? _( "(empty)" ) : enumerate( category_whitelist ) ) );
+                       v.category_whitelist.empty() ? _( "(empty)" ) : enumerate( v.category_whitelist ) ) );
     info.emplace_back( "BASE", string_format( _( "Category Blacklist: %s" ),
-                       category_blacklist.empty() ? _( "(empty)" ) : enumerate( category_blacklist ) ) );
+                       v.category_blacklist.empty() ? _( "(empty)" ) : enumerate( v.category_blacklist ) ) );
 }
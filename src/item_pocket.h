@@ -66,9 +66,7 @@ class item_pocket
                 void clear();
 
                 void set_priority( int priority );
-                int priority() const {
-                    return priority_rating;
-                }
+                int priority() const;
 
                 // have these settings been modified by the player?
                 bool is_null() const;
@@ -113,16 +111,25 @@ class item_pocket
                 void serialize( JsonOut &json ) const;
                 void deserialize( const JsonObject &data );
             private:
-                std::optional<std::string> preset_name;
-                int priority_rating = 0;
-                cata::flat_set<itype_id> item_whitelist;
-                cata::flat_set<itype_id> item_blacklist;
-                cata::flat_set<item_category_id> category_whitelist;
-                cata::flat_set<item_category_id> category_blacklist;
-                bool collapsed = false;
-                bool disabled = false;
-                bool unload = true;
-                bool player_edited = false;
+                struct settings_values {
+                    std::optional<std::string> preset_name;
+                    int priority_rating = 0;
+                    cata::flat_set<itype_id> item_whitelist;
+                    cata::flat_set<itype_id> item_blacklist;
+                    cata::flat_set<item_category_id> category_whitelist;
+                    cata::flat_set<item_category_id> category_blacklist;
+                    bool collapsed = false;
+                    bool disabled = false;
+                    bool unload = true;
+                    bool player_edited = false;
+                };
+
+                // Every container that spawns gets its pockets, and hardly any of them are ever
+                // configured, so the values are only allocated once one of them is changed.
+                const settings_values &get() const;
+                settings_values &edit();
+
+                cata::value_ptr<settings_values> values;
         };
 
         item_pocket() = default;
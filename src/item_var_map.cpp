@@ -0,0 +1,238 @@
+#include "item_var_map.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "json.h"
+#include "string_formatter.h"
+
+namespace
+{
+
+// Interned variable names.  Unlike string_id this table is guarded, as items are
+// queried from worker threads as well.
+struct var_name_table {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, int> keys;
+    std::vector<const std::string *> names;
+};
+
+} // namespace
+
+static var_name_table &get_var_name_table()
+{
+    static var_name_table table;
+    return table;
+}
+
+// Returns -1 if nothing was ever stored under name.
+static int find_key( const std::string &name )
+{
+    var_name_table &table = get_var_name_table();
+    std::shared_lock<std::shared_mutex> lk( table.mutex );
+    const auto it = table.keys.find( name );
+    return it == table.keys.end() ? -1 : it->second;
+}
+
+static int intern_key( const std::string &name )
+{
+    const int key = find_key( name );
+    if( key >= 0 ) {
+        return key;
+    }
+    var_name_table &table = get_var_name_table();
+    std::unique_lock<std::shared_mutex> lk( table.mutex );
+    const auto inserted = table.keys.emplace( name, static_cast<int>( table.names.size() ) );
+    if( inserted.second ) {
+        table.names.push_back( &inserted.first->first );
+    }
+    return inserted.first->second;
+}
+
+const std::string &item_var_map::name_of( const int key )
+{
+    var_name_table &table = get_var_name_table();
+    std::shared_lock<std::shared_mutex> lk( table.mutex );
+    return *table.names[key];
+}
+
+item_var_map::item_var_map( const std::map<std::string, std::string> &vars )
+{
+    entries.reserve( vars.size() );
+    for( const std::pair<const std::string, std::string> &var : vars ) {
+        set( var.first, from_string( var.second ) );
+    }
+}
+
+const item_var_map::var_value *item_var_map::find( const std::string &name ) const
+{
+    if( entries.empty() ) {
+        return nullptr;
+    }
+    const int key = find_key( name );
+    const auto it = std::lower_bound( entries.begin(), entries.end(), key,
+    []( const entry & e, int k ) {
+        return e.key < k;
+    } );
+    return it == entries.end() || it->key != key ? nullptr : &it->value;
+}
+
+void item_var_map::set( const std::string &name, var_value value )
+{
+    const int key = intern_key( name );
+    const auto it = std::lower_bound( entries.begin(), entries.end(), key,
+    []( const entry & e, int k ) {
+        return e.key < k;
+    } );
+    if( it != entries.end() && it->key == key ) {
+        it->value = std::move( value );
+    } else {
+        entries.insert( it, entry{ key, std::move( value ) } );
+    }
+}
+
+std::string &item_var_map::string_value( const std::string &name )
+{
+    const int key = intern_key( name );
+    auto it = std::lower_bound( entries.begin(), entries.end(), key,
+    []( const entry & e, int k ) {
+        return e.key < k;
+    } );
+    if( it == entries.end() || it->key != key ) {
+        it = entries.insert( it, entry{ key, std::string() } );
+    } else if( !std::holds_alternative<std::string>( it->value ) ) {
+        it->value = to_string( it->value );
+    }
+    return std::get<std::string>( it->value );
+}
+
+void item_var_map::erase( const std::string &name )
+{
+    if( entries.empty() ) {
+        return;
+    }
+    const int key = find_key( name );
+    const auto it = std::lower_bound( entries.begin(), entries.end(), key,
+    []( const entry & e, int k ) {
+        return e.key < k;
+    } );
+    if( it != entries.end() && it->key == key ) {
+        entries.erase( it );
+    }
+}
+
+bool item_var_map::equal_ignoring( const item_var_map &rhs,
+                                   const std::set<std::string> &ignored ) const
+{
+    const auto is_ignored = [&ignored]( int key ) {
+        return !ignored.empty() && ignored.count( name_of( key ) ) > 0;
+    };
+    // Both sides are sorted by key, so walk them side by side and only look up the names of
+    // variables that differ.
+    size_t l = 0;
+    size_t r = 0;
+    while( l < entries.size() || r < rhs.entries.size() ) {
+        if( r == rhs.entries.size() ||
+            ( l < entries.size() && entries[l].key < rhs.entries[r].key ) ) {
+            if( !is_ignored( entries[l].key ) ) {
+                return false;
+            }
+            ++l;
+        } else if( l == entries.size() || rhs.entries[r].key < entries[l].key ) {
+            if( !is_ignored( rhs.entries[r].key ) ) {
+                return false;
+            }
+            ++r;
+        } else {
+            if( !values_equal( entries[l].value, rhs.entries[r].value ) &&
+                !is_ignored( entries[l].key ) ) {
+                return false;
+            }
+            ++l;
+            ++r;
+        }
+    }
+    return true;
+}
+
+std::string item_var_map::to_string( const var_value &value )
+{
+    if( const long long *i = std::get_if<long long>( &value ) ) {
+        return std::to_string( *i );
+    }
+    if( const double *d = std::get_if<double>( &value ) ) {
+        return string_format( "%f", *d );
+    }
+    return std::get<std::string>( value );
+}
+
+item_var_map::var_value item_var_map::from_string( std::string str )
+{
+    if( str.empty() || str.size() > 32 ) {
+        return str;
+    }
+    const char *begin = str.c_str();
+    char *end = nullptr;
+    if( str.find( '.' ) == std::string::npos ) {
+        errno = 0;
+        const long long i = std::strtoll( begin, &end, 10 );
+        if( errno == 0 && end == begin + str.size() && std::to_string( i ) == str ) {
+            return i;
+        }
+    } else {
+        errno = 0;
+        const double d = std::strtod( begin, &end );
+        if( errno == 0 && end == begin + str.size() && string_format( "%f", d ) == str ) {
+            return d;
+        }
+    }
+    return str;
+}
+
+bool item_var_map::values_equal( const var_value &lhs, const var_value &rhs )
+{
+    if( lhs.index() == rhs.index() && lhs == rhs ) {
+        return true;
+    }
+    // Values used to be compared as the strings they were stored as.
+    return to_string( lhs ) == to_string( rhs );
+}
+
+std::vector<const item_var_map::entry *> item_var_map::sorted_by_name() const
+{
+    std::vector<std::pair<const std::string *, const entry *>> named;
+    named.reserve( entries.size() );
+    for( const entry &e : entries ) {
+        named.emplace_back( &name_of( e.key ), &e );
+    }
+    std::sort( named.begin(), named.end(), []( const auto & lhs, const auto & rhs ) {
+        return *lhs.first < *rhs.first;
+    } );
+    std::vector<const entry *> sorted;
+    sorted.reserve( named.size() );
+    for( const std::pair<const std::string *, const entry *> &n : named ) {
+        sorted.push_back( n.second );
+    }
+    return sorted;
+}
+
+void item_var_map::serialize( JsonOut &jsout ) const
+{
+    jsout.start_object();
+    for_each( [&jsout]( const std::string & name, const var_value & value ) {
+        jsout.member( name, to_string( value ) );
+    } );
+    jsout.end_object();
+}
+
+void item_var_map::deserialize( const JsonObject &jo )
+{
+    entries.clear();
+    for( const JsonMember &member : jo ) {
+        set( member.name(), from_string( member.get_string() ) );
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef CATA_SRC_ITEM_VAR_MAP_H
+#define CATA_SRC_ITEM_VAR_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+class JsonObject;
+class JsonOut;
+
+/**
+ * Storage for the variables of an item (see item::set_var).
+ *
+ * Names are interned, so a lookup is a hash of the name followed by a scan of a few integers,
+ * and copying an item does not copy them.  Numbers are kept as numbers and only formatted
+ * when they are read back as strings or saved, which keeps the save format the same as when
+ * every value was a string.
+ */
+class item_var_map
+{
+    public:
+        using var_value = std::variant<std::string, long long, double>;
+
+        item_var_map() = default;
+        /** Takes the variables as they are loaded from json, e.g. for itype::item_variables. */
+        explicit item_var_map( const std::map<std::string, std::string> &vars );
+
+        bool empty() const {
+            return entries.empty();
+        }
+        size_t size() const {
+            return entries.size();
+        }
+        void clear() {
+            entries.clear();
+        }
+
+        /** Returns the value of the variable, or nullptr if it is not set. */
+        const var_value *find( const std::string &name ) const;
+        bool contains( const std::string &name ) const {
+            return find( name ) != nullptr;
+        }
+        void set( const std::string &name, var_value value );
+        /**
+         * Returns the value as a string that can be modified in place, converting a number
+         * or adding an empty string first if needed.
+         */
+        std::string &string_value( const std::string &name );
+        void erase( const std::string &name );
+
+        /** Calls func( name, value ) for every variable, in the order of their names. */
+        template<typename F>
+        void for_each( F &&func ) const {
+            for( const entry *e : sorted_by_name() ) {
+                func( name_of( e->key ), e->value );
+            }
+        }
+        /** Removes every variable for which pred( name, value ) returns true. */
+        template<typename F>
+        void erase_if( F &&pred ) {
+            entries.erase( std::remove_if( entries.begin(), entries.end(), [&]( const entry & e ) {
+                return pred( name_of( e.key ), e.value );
+            } ), entries.end() );
+        }
+
+        /** Compares the variables, skipping those named in ignored. */
+        bool equal_ignoring( const item_var_map &rhs, const std::set<std::string> &ignored ) const;
+        bool operator==( const item_var_map &rhs ) const {
+            return equal_ignoring( rhs, {} );
+        }
+        bool operator!=( const item_var_map &rhs ) const {
+            return !( *this == rhs );
+        }
+
+        /** The value as it is written to the save. */
+        static std::string to_string( const var_value &value );
+        /**
+         * Parses a value read from the save.  Numbers are only recognized in the exact form
+         * to_string would give them, so that writing them back gives the same text.
+         */
+        static var_value from_string( std::string str );
+        /** Same value, regardless of whether either side is stored as a number or a string. */
+        static bool values_equal( const var_value &lhs, const var_value &rhs );
+
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( const JsonObject &jo );
+
+    private:
+        struct entry {
+            int key;
+            var_value value;
+        };
+
+        static const std::string &name_of( int key );
+        std::vector<const entry *> sorted_by_name() const;
+
+        // Sorted by key.
+        std::vector<entry> entries;
+};
+
+#endif // CATA_SRC_ITEM_VAR_MAP_H
@@ -21,6 +21,7 @@
 #include "explosion.h"
 #include "game_constants.h"
 #include "item_pocket.h"
+#include "item_var_map.h"
 #include "iuse.h" // use_function
 #include "mapdata.h"
 #include "proficiency.h"
@@ -1333,7 +1334,7 @@ struct itype {
         std::map<std::string, std::string> properties;
 
         // Item vars are loaded from the type, but assigned and de/serialized with the item itself
-        std::map<std::string, std::string> item_variables;
+        item_var_map item_variables;
 
         // What we're made of (material names). .size() == made of nothing.
         // First -> the material
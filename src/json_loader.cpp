@@ -1,10 +1,16 @@
 #include "json_loader.h"
 
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include <ghc/fs_std_fwd.hpp>
 
+#include "cata_thread_pool.h"
+#include "debug.h"
 #include "filesystem.h"
 #include "flexbuffer_cache.h"
 #include "flexbuffer_json.h"
@@ -43,6 +49,7 @@ flexbuffer_cache &user_cache()
 }
 
 std::unordered_map<std::string, std::unique_ptr<flexbuffer_cache>> save_caches;
+std::mutex save_caches_mutex;
 
 // There's no measurable need to persist flatbuffers for save data, so just create a per-world 'cache' which parses
 // but doesn't disk-cache the parsed flatbuffer.
@@ -58,6 +65,7 @@ flexbuffer_cache &cache_for_save( const cata_path &path )
     std::string folder_or_file = path_it->u8string();
     ++path_it;
 
+    std::lock_guard<std::mutex> lk( save_caches_mutex );
     auto it = save_caches.find( worldname_str );
     if( it == save_caches.end() ) {
         it = save_caches.emplace( worldname_str,
@@ -93,24 +101,46 @@ flexbuffer_cache &cache_for_lexically_normal_path( const cata_path &path )
 }
 
 // The file pointed to by source_file must exist.
-std::optional<JsonValue> from_path_at_offset_opt_impl( const cata_path &source_file,
+std::shared_ptr<parsed_flexbuffer> parse_path_at_offset( const cata_path &source_file,
         size_t offset )
 {
     cata_path lexically_normal_path = source_file.lexically_normal();
-    std::shared_ptr<parsed_flexbuffer> buffer;
     if( lexically_normal_path.get_logical_root() != cata_path::root_path::unknown ) {
         flexbuffer_cache &cache = cache_for_lexically_normal_path( lexically_normal_path );
-        buffer = cache.parse_and_cache(
-                     lexically_normal_path.get_unrelative_path(), offset );
-    } else {
-        buffer = flexbuffer_cache::parse( lexically_normal_path.get_unrelative_path(), offset );
+        return cache.parse_and_cache( lexically_normal_path.get_unrelative_path(), offset );
     }
+    return flexbuffer_cache::parse( lexically_normal_path.get_unrelative_path(), offset );
+}
+
+JsonValue json_value_from_buffer( std::shared_ptr<parsed_flexbuffer> buffer )
+{
+    flexbuffers::Reference buffer_root = flexbuffer_root_from_storage( buffer->get_storage() );
+    return JsonValue( std::move( buffer ), buffer_root, nullptr, 0 );
+}
+
+// The file pointed to by source_file must exist.
+std::optional<JsonValue> from_path_at_offset_opt_impl( const cata_path &source_file,
+        size_t offset )
+{
+    std::shared_ptr<parsed_flexbuffer> buffer = parse_path_at_offset( source_file, offset );
     if( !buffer ) {
         return std::nullopt;
     }
+    return json_value_from_buffer( std::move( buffer ) );
+}
 
-    flexbuffers::Reference buffer_root = flexbuffer_root_from_storage( buffer->get_storage() );
-    return JsonValue( std::move( buffer ), buffer_root, nullptr, 0 );
+std::shared_ptr<parsed_flexbuffer> parse_existing_path( const cata_path &source_file )
+{
+    fs::path unrelative_path = source_file.get_unrelative_path();
+    if( !file_exist( unrelative_path ) ) {
+        throw JsonError( unrelative_path.generic_u8string() + " does not exist." );
+    }
+    std::shared_ptr<parsed_flexbuffer> buffer = parse_path_at_offset( source_file, 0 );
+    if( !buffer ) {
+        throw JsonError( "Json file " + unrelative_path.generic_u8string() +
+                         " did not contain valid json" );
+    }
+    return buffer;
 }
 
 } // namespace
@@ -151,6 +181,62 @@ JsonValue json_loader::from_path( const cata_path &source_file ) noexcept( false
     return from_path_at_offset( source_file, 0 );
 }
 
+std::vector<JsonValue> json_loader::from_paths( const cata_path &source_root,
+        const std::vector<cata_path> &source_files, bool use_snapshot ) noexcept( false )
+{
+    std::vector<JsonValue> ret;
+    ret.reserve( source_files.size() );
+
+    std::optional<flexbuffer_snapshot> snapshot;
+    if( use_snapshot && !source_files.empty() ) {
+        std::vector<fs::path> source_paths;
+        source_paths.reserve( source_files.size() );
+        for( const cata_path &file : source_files ) {
+            source_paths.push_back( file.lexically_normal().get_unrelative_path() );
+        }
+        snapshot = flexbuffer_snapshot::open(
+                       ( PATH_INFO::user_dir_path() / "cache" / "snapshots" ).get_unrelative_path(),
+                       source_root.lexically_normal().generic_u8string(), std::move( source_paths ) );
+        if( snapshot->is_loaded() ) {
+            for( size_t i = 0; i < source_files.size(); ++i ) {
+                ret.push_back( json_value_from_buffer( snapshot->get( i ) ) );
+            }
+            return ret;
+        }
+    }
+
+    // Files are parsed independently of each other, so spread them over the worker pool.
+    // Debug messages are reported afterwards on this thread, in file order.  If several files
+    // fail, the error of the first one in the list is reported, as it would be when parsing
+    // them one by one.
+    std::vector<std::shared_ptr<parsed_flexbuffer>> buffers( source_files.size() );
+    std::vector<std::vector<deferred_debugmsg>> messages( source_files.size() );
+    std::vector<std::exception_ptr> errors( source_files.size() );
+    cata::parallel_for( source_files.size(), [&]( size_t i ) {
+        messages[i] = defer_debugmsgs_during( [&]() {
+            try {
+                buffers[i] = parse_existing_path( source_files[i] );
+            } catch( ... ) {
+                errors[i] = std::current_exception();
+            }
+        } );
+    } );
+    for( size_t i = 0; i < source_files.size(); ++i ) {
+        replay_deferred_debugmsgs( messages[i] );
+        if( errors[i] ) {
+            std::rethrow_exception( errors[i] );
+        }
+    }
+    if( snapshot ) {
+        // Not being able to write the snapshot only costs time on the next launch.
+        snapshot->save( buffers );
+    }
+    for( std::shared_ptr<parsed_flexbuffer> &buffer : buffers ) {
+        ret.push_back( json_value_from_buffer( std::move( buffer ) ) );
+    }
+    return ret;
+}
+
 JsonValue json_loader::from_string( std::string const &data ) noexcept( false )
 {
     std::shared_ptr<parsed_flexbuffer> buffer = flexbuffer_cache::parse_buffer( data );
@@ -2,6 +2,8 @@
 #ifndef CATA_SRC_JSON_LOADER_H
 #define CATA_SRC_JSON_LOADER_H
 
+#include <vector>
+
 #include <ghc/fs_std_fwd.hpp>
 
 #include "path_info.h"
@@ -22,6 +24,14 @@ class json_loader
         static std::optional<JsonValue> from_path_at_offset_opt( const cata_path &source_file,
                 size_t offset = 0 ) noexcept( false );
 
+        // Like json_loader::from_path for each of source_files, in order. The files are parsed
+        // in parallel on the worker pool; if any of them fail, the error of the first is thrown.
+        // With use_snapshot the parsed files are also stored as a single snapshot keyed on their
+        // paths and mtimes, and later calls for the same, unchanged, files under source_root map
+        // that snapshot rather than going through the cache file by file.
+        static std::vector<JsonValue> from_paths( const cata_path &source_root,
+                const std::vector<cata_path> &source_files, bool use_snapshot ) noexcept( false );
+
         // Like json_loader::from_path, except instead of parsing data from a file, will parse data from a string in memory.
         static JsonValue from_string( std::string const &data ) noexcept( false );
         static std::optional<JsonValue> from_string_opt( std::string const &data ) noexcept( false );
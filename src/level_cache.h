@@ -6,8 +6,11 @@
 #include <bitset>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "coordinates.h"
 #include "game_constants.h"
 #include "lightmap.h"
 #include "point.h"
@@ -23,6 +26,9 @@ struct level_cache {
         level_cache( const level_cache &other ) = default;
 
         std::bitset<MAPSIZE *MAPSIZE> transparency_cache_dirty;
+        // Single tiles to recalculate, for changes that can't affect the rest of their submap.
+        // Only points outside the submaps marked in transparency_cache_dirty are kept.
+        std::unordered_set<point_bub_ms> transparency_dirty_points;
         bool outside_cache_dirty = false;
         bool floor_cache_dirty = false;
         bool seen_cache_dirty = false;
@@ -62,6 +68,9 @@ struct level_cache {
         // initial values derived from transparency_cache, uses same units
         // examples of adjustment: changed transparency on player's tile and special case for crouching
         cata::mdarray<float, point_bub_ms> vision_transparency_cache;
+        // Tiles where vision_transparency_cache was adjusted for the player rather than the
+        // terrain, to be restored when only some tiles are brought up to date.
+        std::vector<point_bub_ms> vision_transparency_overrides;
 
         // stores "visibility" of the tiles to the player
         // values range from 1 (fully visible to player) to 0 (not visible)
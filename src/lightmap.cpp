@@ -1,6 +1,7 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <bitset>
 #include <cmath>
 #include <cstdlib>
@@ -15,6 +16,7 @@
 #include "avatar.h"
 #include "cached_options.h"
 #include "calendar.h"
+#include "cata_thread_pool.h"
 #include "cata_utility.h"
 #include "character.h"
 #include "colony.h"
@@ -84,6 +86,35 @@ void map::add_light_from_items( const tripoint_bub_ms &p, const item_stack &item
     }
 }
 
+// Transparency of a single tile, with and without its fields.
+static std::pair<float, float> calc_transparency( const submap &sm, const point_sm_ms &sp,
+        const bool outside, const float sight_penalty )
+{
+    float value = LIGHT_TRANSPARENCY_OPEN_AIR;
+
+    if( !( sm.get_ter( sp ).obj().transparent && sm.get_furn( sp ).obj().transparent ) ) {
+        return std::make_pair( LIGHT_TRANSPARENCY_SOLID, LIGHT_TRANSPARENCY_SOLID );
+    }
+    if( outside ) {
+        // FIXME: Places inside vehicles haven't been marked as
+        // inside yet so this is incorrectly penalising for
+        // weather in vehicles.
+        value *= sight_penalty;
+    }
+    float value_wo_fields = value;
+    for( const auto &fld : sm.get_field( sp ) ) {
+        const field_intensity_level &i_level = fld.second.get_intensity_level();
+        if( i_level.transparent ) {
+            continue;
+        }
+        // Fields are either transparent or not, however we want some to be translucent
+        value = value * i_level.translucency;
+    }
+    // TODO: [lightmap] Have glass reduce light as well.
+    // Note, binary transluceny is implemented in build_vision_transparency_cache below
+    return std::make_pair( value, value_wo_fields );
+}
+
 // TODO: Consider making this just clear the cache and dynamically fill it in as is_transparent() is called
 bool map::build_transparency_cache( const int zlev )
 {
@@ -92,7 +123,7 @@ bool map::build_transparency_cache( const int zlev )
     auto &transparency_cache = map_cache.transparency_cache;
     auto &outside_cache = map_cache.outside_cache;
 
-    if( map_cache.transparency_cache_dirty.none() ) {
+    if( map_cache.transparency_cache_dirty.none() && map_cache.transparency_dirty_points.empty() ) {
         return false;
     }
 
@@ -110,9 +141,45 @@ bool map::build_transparency_cache( const int zlev )
 
     const float sight_penalty = get_weather().weather_id->sight_penalty;
 
+    // Single tiles first: most of them are fields changing intensity, which often leaves the
+    // transparency as it was.  Those need no further work, here or in the vision cache.
+    if( rebuild_all ) {
+        // The old values are gone, so there is nothing to compare the new ones with.
+        map_cache.transparency_dirty_points.clear();
+        set_seen_cache_dirty( zlev );
+    }
+    for( auto it = map_cache.transparency_dirty_points.begin();
+         it != map_cache.transparency_dirty_points.end(); ) {
+        const point_bub_ms p = *it;
+        point_sm_ms sp;
+        const submap *cur_submap = get_submap_at( tripoint_bub_ms( p, zlev ), sp );
+        if( cur_submap == nullptr ) {
+            ++it;
+            continue;
+        }
+        float value;
+        float value_wo_fields;
+        std::tie( value, value_wo_fields ) = calc_transparency( *cur_submap, sp,
+                                             outside_cache[p.x()][p.y()], sight_penalty );
+        const bool transparent_wo_fields = value_wo_fields > LIGHT_TRANSPARENCY_SOLID;
+        if( value == transparency_cache[p.x()][p.y()] &&
+            transparent_wo_fields == transparent_cache_wo_fields[p.x()][p.y()] ) {
+            it = map_cache.transparency_dirty_points.erase( it );
+            continue;
+        }
+        transparency_cache[p.x()][p.y()] = value;
+        transparent_cache_wo_fields[p.x()][p.y()] = transparent_wo_fields;
+        set_seen_cache_dirty( tripoint_bub_ms( p, zlev ) );
+        ++it;
+    }
+
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !rebuild_all && !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
+                continue;
+            }
+
             const submap *cur_submap = get_submap_at_grid( tripoint_rel_sm{smx, smy, zlev} );
             if( cur_submap == nullptr ) {
                 debugmsg( "Tried to build transparency cache at (%d,%d,%d) but the submap is not loaded", smx, smy,
@@ -122,47 +189,23 @@ bool map::build_transparency_cache( const int zlev )
 
             const point sm_offset = coords::project_to<coords::ms>( point_rel_sm( smx, smy ) ).raw();
 
-            if( !rebuild_all && !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
-                continue;
-            }
-
-            // calculates transparency of a single tile
-            // x,y - coords in map local coords
-            auto calc_transp = [&]( const point_sm_ms & p ) {
-                const point_sm_ms sp = p - sm_offset;
-                float value = LIGHT_TRANSPARENCY_OPEN_AIR;
-
-                if( !( cur_submap->get_ter( sp ).obj().transparent &&
-                       cur_submap->get_furn( sp ).obj().transparent ) ) {
-                    return std::make_pair( LIGHT_TRANSPARENCY_SOLID, LIGHT_TRANSPARENCY_SOLID );
-                }
-                if( outside_cache[p.x()][p.y()] ) {
-                    // FIXME: Places inside vehicles haven't been marked as
-                    // inside yet so this is incorrectly penalising for
-                    // weather in vehicles.
-                    value *= sight_penalty;
-                }
-                float value_wo_fields = value;
-                for( const auto &fld : cur_submap->get_field( sp ) ) {
-                    const field_intensity_level &i_level = fld.second.get_intensity_level();
-                    if( i_level.transparent ) {
-                        continue;
-                    }
-                    // Fields are either transparent or not, however we want some to be translucent
-                    value = value * i_level.translucency;
-                }
-                // TODO: [lightmap] Have glass reduce light as well.
-                // Note, binary transluceny is implemented in build_vision_transparency_cache below
-                return std::make_pair( value, value_wo_fields );
-            };
-
             if( cur_submap->is_uniform() ) {
                 float value;
                 float dummy;
-                std::tie( value, dummy ) = calc_transp( point_sm_ms( sm_offset ) );
+                std::tie( value, dummy ) = calc_transparency( *cur_submap, point_sm_ms::zero,
+                                           outside_cache[sm_offset.x][sm_offset.y], sight_penalty );
                 // if rebuild_all==true all values were already set to LIGHT_TRANSPARENCY_OPEN_AIR
                 if( !rebuild_all || value != LIGHT_TRANSPARENCY_OPEN_AIR ) {
                     bool opaque = value <= LIGHT_TRANSPARENCY_SOLID;
+                    for( int sx = 0; sx < SEEX && !rebuild_all; ++sx ) {
+                        for( int sy = 0; sy < SEEY; ++sy ) {
+                            const point_bub_ms p( sm_offset.x + sx, sm_offset.y + sy );
+                            if( transparency_cache[p.x()][p.y()] != value ||
+                                transparent_cache_wo_fields[p.x()][p.y()] == opaque ) {
+                                set_seen_cache_dirty( tripoint_bub_ms( p, zlev ) );
+                            }
+                        }
+                    }
                     for( int sx = 0; sx < SEEX; ++sx ) {
                         // init all sy indices in one go
                         std::uninitialized_fill_n( &transparency_cache[sm_offset.x + sx][sm_offset.y], SEEY, value );
@@ -179,9 +222,17 @@ bool map::build_transparency_cache( const int zlev )
                     const int x = sx + sm_offset.x;
                     for( int sy = 0; sy < SEEY; ++sy ) {
                         const int y = sy + sm_offset.y;
+                        float value;
                         float transp_wo_fields;
-                        std::tie( transparency_cache[x][y], transp_wo_fields ) = calc_transp( {x, y } );
-                        transparent_cache_wo_fields[x][y] = transp_wo_fields > LIGHT_TRANSPARENCY_SOLID;
+                        std::tie( value, transp_wo_fields ) = calc_transparency(
+                                *cur_submap, point_sm_ms( sx, sy ), outside_cache[x][y], sight_penalty );
+                        const bool transparent_wo_fields = transp_wo_fields > LIGHT_TRANSPARENCY_SOLID;
+                        if( !rebuild_all && ( value != transparency_cache[x][y] ||
+                                              transparent_wo_fields != transparent_cache_wo_fields[x][y] ) ) {
+                            set_seen_cache_dirty( tripoint_bub_ms( x, y, zlev ) );
+                        }
+                        transparency_cache[x][y] = value;
+                        transparent_cache_wo_fields[x][y] = transparent_wo_fields;
                     }
                 }
             }
@@ -196,22 +247,72 @@ bool map::build_vision_transparency_cache( int zlev )
     level_cache &map_cache = get_cache( zlev );
 
     // We copy the transparency_cache so we need to recalc if it's dirty
-    if( map_cache.transparency_cache_dirty.none() /*&& map_cache.vision_transparency_cache_dirty.none()*/ ) {
+    if( map_cache.transparency_cache_dirty.none() && map_cache.transparency_dirty_points.empty() ) {
         return false;
     }
 
     const cata::mdarray<float, point_bub_ms> &transparency_cache = map_cache.transparency_cache;
     cata::mdarray<float, point_bub_ms> &vision_transparency_cache = map_cache.vision_transparency_cache;
 
-    // TODO: Should only copy if transparency_cache was dirty
-    memcpy( &vision_transparency_cache, &transparency_cache, sizeof( transparency_cache ) );
+    bool dirty = false;
+
+    // Blocks vision through TRANSLUCENT flagged terrain.
+    const auto apply_translucency = [&]( const submap & sm, const point_sm_ms & sp, const point & p ) {
+        if( sm.get_ter( sp ).obj().has_flag( ter_furn_flag::TFLAG_TRANSLUCENT ) ) {
+            dirty |= vision_transparency_cache[p.x][p.y] != LIGHT_TRANSPARENCY_SOLID;
+            vision_transparency_cache[p.x][p.y] = LIGHT_TRANSPARENCY_SOLID;
+        }
+    };
+
+    if( map_cache.transparency_cache_dirty.none() ) {
+        // Only single tiles changed, so only they and the tiles adjusted for the player last
+        // time need to be brought up to date.
+        const auto refresh = [&]( const point_bub_ms & p ) {
+            const float old_value = vision_transparency_cache[p.x()][p.y()];
+            vision_transparency_cache[p.x()][p.y()] = transparency_cache[p.x()][p.y()];
+            point_sm_ms sp;
+            if( const submap *cur_submap = get_submap_at( tripoint_bub_ms( p, zlev ), sp ) ) {
+                apply_translucency( *cur_submap, sp, p.raw() );
+            }
+            return old_value != vision_transparency_cache[p.x()][p.y()];
+        };
+        for( const point_bub_ms &p : map_cache.vision_transparency_overrides ) {
+            dirty |= refresh( p );
+        }
+        for( const point_bub_ms &p : map_cache.transparency_dirty_points ) {
+            refresh( p );
+        }
+    } else {
+        // TODO: Should only copy if transparency_cache was dirty
+        memcpy( &vision_transparency_cache, &transparency_cache, sizeof( transparency_cache ) );
+
+        // Traverse the submaps in order (else map::ter() calls get_submap each time)
+        for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+            for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+                const submap *cur_submap = get_submap_at_grid( tripoint_rel_sm{smx, smy, zlev} );
+                if( cur_submap == nullptr ) {
+                    debugmsg( "Tried to build transparency cache at (%d,%d,%d) but the submap is not loaded", smx,
+                              smy, zlev );
+                    continue;
+                }
+                if( !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
+                    continue;
+                }
+                for( int smi = 0; smi < SEEX; smi++ ) {
+                    for( int smj = 0; smj < SEEY; smj++ ) {
+                        apply_translucency( *cur_submap, point_sm_ms{smi, smj},
+                                            point( smi + smx * SEEX, smj + smy * SEEY ) );
+                    }
+                }
+            }
+        }
+    }
+    map_cache.vision_transparency_overrides.clear();
 
     const Character &player_character = get_player_character();
     const tripoint_bub_ms p = player_character.pos_bub();
     const bool is_player_z = p.z() == zlev;
 
-    bool dirty = false;
-
     if( is_player_z ) {
         // This segment handles vision when the player is crouching or prone. It only checks adjacent tiles.
         // If you change this, also consider creature::sees and map::obstacle_coverage.
@@ -230,33 +331,7 @@ bool map::build_vision_transparency_cache( int zlev )
                     // If we're crouching or prone behind an obstacle, we can't see past it.
                     dirty |= vision_transparency_cache[loc.x()][loc.y()] != LIGHT_TRANSPARENCY_SOLID;
                     vision_transparency_cache[loc.x()][loc.y()] = LIGHT_TRANSPARENCY_SOLID;
-                }
-            }
-        }
-    }
-
-    // This segment handles blocking vision through TRANSLUCENT flagged terrain.
-    // Traverse the submaps in order (else map::ter() calls get_submap each time)
-    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
-        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            const submap *cur_submap = get_submap_at_grid( tripoint_rel_sm{smx, smy, zlev} );
-            if( cur_submap == nullptr ) {
-                debugmsg( "Tried to build transparency cache at (%d,%d,%d) but the submap is not loaded", smx, smy,
-                          zlev );
-                continue;
-            }
-            if( !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
-                continue;
-            }
-            for( int smi = 0; smi < SEEX; smi++ ) {
-                for( int smj = 0; smj < SEEY; smj++ ) {
-                    if( cur_submap->get_ter( point_sm_ms{smi, smj} ).obj().has_flag(
-                            ter_furn_flag::TFLAG_TRANSLUCENT ) ) {
-                        const int i = smi + ( smx * SEEX );
-                        const int j = smj + ( smy * SEEY );
-                        dirty |= vision_transparency_cache[i][j] != LIGHT_TRANSPARENCY_SOLID;
-                        vision_transparency_cache[i][j] = LIGHT_TRANSPARENCY_SOLID;
-                    }
+                    map_cache.vision_transparency_overrides.push_back( loc.xy() );
                 }
             }
         }
@@ -266,9 +341,11 @@ bool map::build_vision_transparency_cache( int zlev )
     // Shouldn't this be handled in the player's seen cache instead??
     if( is_player_z && inbounds( p ) ) {
         vision_transparency_cache[p.x()][p.y()] = LIGHT_TRANSPARENCY_OPEN_AIR;
+        map_cache.vision_transparency_overrides.push_back( p.xy() );
     }
 
     map_cache.transparency_cache_dirty.reset();
+    map_cache.transparency_dirty_points.clear();
     return dirty;
 }
 
@@ -641,10 +718,45 @@ void map::generate_lightmap( const int zlev )
     */
     const tripoint_bub_ms cache_start( 0, 0, zlev );
     const tripoint_bub_ms cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
+    std::vector<tripoint_bub_ms> buffered_sources;
     for( const tripoint_bub_ms &p : points_in_rectangle( cache_start, cache_end ) ) {
         if( light_source_buffer[p.x()][p.y()] > 0.0 ) {
+            buffered_sources.push_back( p );
+        }
+    }
+    // Light only ever raises lm and sm, so sources can be cast into separate maps and merged by
+    // taking the maximum, with the same result as casting them one after another.  Each map
+    // costs a pass over the whole level to merge, so it takes quite a few sources to pay off.
+    constexpr size_t min_sources_per_task = 32;
+    const size_t num_tasks = std::min<size_t>( buffered_sources.size() / min_sources_per_task,
+                             cata::parallel_thread_count() );
+    if( num_tasks <= 1 || cata::in_parallel_task() ) {
+        for( const tripoint_bub_ms &p : buffered_sources ) {
             apply_light_source( p, light_source_buffer[p.x()][p.y()] );
         }
+    } else {
+        std::vector<std::unique_ptr<cata::mdarray<four_quadrants, point_bub_ms>>> task_lm( num_tasks );
+        std::vector<std::unique_ptr<cata::mdarray<float, point_bub_ms>>> task_sm( num_tasks );
+        cata::parallel_for( num_tasks, [&]( size_t task ) {
+            task_lm[task] = std::make_unique<cata::mdarray<four_quadrants, point_bub_ms>>();
+            task_sm[task] = std::make_unique<cata::mdarray<float, point_bub_ms>>();
+            task_lm[task]->fill( four_quadrants{} );
+            task_sm[task]->fill( 0 );
+            for( size_t i = task; i < buffered_sources.size(); i += num_tasks ) {
+                const tripoint_bub_ms &p = buffered_sources[i];
+                apply_light_source( p, light_source_buffer[p.x()][p.y()], *task_lm[task], *task_sm[task] );
+            }
+        } );
+        for( size_t task = 0; task < num_tasks; ++task ) {
+            const cata::mdarray<four_quadrants, point_bub_ms> &src_lm = *task_lm[task];
+            const cata::mdarray<float, point_bub_ms> &src_sm = *task_sm[task];
+            for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+                for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                    lm[x][y] = elementwise_max( lm[x][y], src_lm[x][y] );
+                    sm[x][y] = std::max( sm[x][y], src_sm[x][y] );
+                }
+            }
+        }
     }
     for( const std::pair<tripoint_bub_ms, float> &elem : lm_override ) {
         lm[elem.first.x()][elem.first.y()].fill( elem.second );
@@ -1215,11 +1327,17 @@ static bool light_check( const float &transparency, const float &intensity )
 void map::apply_light_source( const tripoint_bub_ms &p, float luminance )
 {
     level_cache &cache = get_cache( p.z() );
-    cata::mdarray<four_quadrants, point_bub_ms> &lm = cache.lm;
-    cata::mdarray<float, point_bub_ms> &sm = cache.sm;
-    cata::mdarray<float, point_bub_ms> &transparency_cache =
+    apply_light_source( p, luminance, cache.lm, cache.sm );
+}
+
+void map::apply_light_source( const tripoint_bub_ms &p, float luminance,
+                              cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                              cata::mdarray<float, point_bub_ms> &sm ) const
+{
+    const level_cache &cache = get_cache_ref( p.z() );
+    const cata::mdarray<float, point_bub_ms> &transparency_cache =
         cache.transparency_cache;
-    cata::mdarray<float, point_bub_ms> &light_source_buffer =
+    const cata::mdarray<float, point_bub_ms> &light_source_buffer =
         cache.light_source_buffer;
 
     const point_bub_ms p2( p.xy() );
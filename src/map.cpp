@@ -11,6 +11,7 @@
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "active_item_cache.h"
@@ -22,6 +23,7 @@
 #include "cached_options.h"
 #include "calendar.h"
 #include "cata_assert.h"
+#include "cata_thread_pool.h"
 #include "cata_type_traits.h"
 #include "character.h"
 #include "character_id.h"
@@ -263,6 +265,7 @@ map::map( int mapsize, bool zlev ) : my_MAPSIZE( mapsize ), my_HALF_MAPSIZE( map
     for( auto &ptr : pathfinding_caches ) {
         ptr = std::make_unique<pathfinding_cache>();
     }
+    routes = std::make_unique<route_cache>();
 
     dbg( D_INFO ) << "map::map(): my_MAPSIZE: " << my_MAPSIZE << " z-levels enabled:" << zlevels;
     traplocs.resize( trap::count() );
@@ -285,7 +288,9 @@ static submap null_submap;
 void map::set_transparency_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
-        get_cache( zlev ).transparency_cache_dirty.set();
+        level_cache &ch = get_cache( zlev );
+        ch.transparency_cache_dirty.set();
+        ch.transparency_dirty_points.clear();
     }
 }
 
@@ -293,7 +298,10 @@ void map::set_transparency_cache_dirty( const tripoint_bub_ms &p, bool field )
 {
     if( inbounds( p ) ) {
         const tripoint_bub_sm smp = coords::project_to<coords::sm>( p );
-        get_cache( smp.z() ).transparency_cache_dirty.set( smp.x() * MAPSIZE + smp.y() );
+        level_cache &ch = get_cache( smp.z() );
+        if( !ch.transparency_cache_dirty[smp.x() * MAPSIZE + smp.y()] ) {
+            ch.transparency_dirty_points.emplace( p.xy() );
+        }
         if( !field ) {
             get_creature_tracker().invalidate_reachability_cache();
         }
@@ -413,6 +421,9 @@ void map::invalidate_map_cache( const int zlev )
         ch.outside_cache_dirty = true;
         set_transparency_cache_dirty( zlev );
     }
+#if defined(TILES)
+    draw_points_cache_dirty = true;
+#endif
 }
 
 const_maptile map::maptile_at( const tripoint_bub_ms &p ) const
@@ -5754,6 +5765,18 @@ static bool process_map_items( map &here, item_stack &items, safe_reference<item
     return false;
 }
 
+// Leaves food alone until it could next rot, freeze or thaw, instead of every few minutes.
+// When it is processed again, it catches up on the time in between.
+static void postpone_processing( active_item_cache &cache, const item_reference &ref,
+                                 const tripoint_bub_ms &location, float insulation,
+                                 temperature_flag flag, float spoil_multiplier )
+{
+    if( ref.item_ref && ref.item_ref->has_temperature() ) {
+        cache.postpone( *ref.item_ref, ref.item_ref->next_state_change( location, insulation, flag,
+                        spoil_multiplier ) );
+    }
+}
+
 static void process_vehicle_items( vehicle &cur_veh, int part )
 {
     vehicle_part &vp = cur_veh.part( part );
@@ -5981,10 +6004,13 @@ void map::process_items_in_submap( submap &current_submap, const tripoint_rel_sm
 
         map_stack items = i_at( map_location );
 
-        process_map_items( *this, items, active_item_ref.item_ref, active_item_ref.parent,
-                           map_location, 1, flag,
-                           spoil_multiplier * active_item_ref.spoil_multiplier(),
-                           furniture_is_sealed || active_item_ref.has_watertight_container() );
+        spoil_multiplier *= active_item_ref.spoil_multiplier();
+        if( !process_map_items( *this, items, active_item_ref.item_ref, active_item_ref.parent,
+                                map_location, 1, flag, spoil_multiplier,
+                                furniture_is_sealed || active_item_ref.has_watertight_container() ) ) {
+            postpone_processing( current_submap.active_items, active_item_ref, map_location, 1,
+                                 flag, spoil_multiplier );
+        }
     }
 }
 
@@ -5995,7 +6021,8 @@ std::vector<item_reference> map::item_network_connections( vehicle *power_grid )
         tripoint_abs_sm const abs_pos = iter;
         const tripoint_rel_sm local_pos = abs_pos - abs_sub.xy();
         submap *const current_submap = get_submap_at_grid( local_pos );
-        std::vector<item_reference> active_items = current_submap->active_items.get_for_processing();
+        // Not get_for_processing(), which would use up the items that are due this turn.
+        std::vector<item_reference> active_items = current_submap->active_items.get();
         for( item_reference &active_item_ref : active_items ) {
             if( !active_item_ref.item_ref ) {
                 continue;
@@ -6091,6 +6118,8 @@ void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap )
         if( !process_map_items( *this, items, active_item_ref.item_ref, active_item_ref.parent,
                                 item_loc, it_insulation, flag,
                                 active_item_ref.spoil_multiplier(), in_tank || active_item_ref.has_watertight_container() ) ) {
+            postpone_processing( cur_veh.active_items, active_item_ref, item_loc, it_insulation, flag,
+                                 active_item_ref.spoil_multiplier() );
             // If the item was NOT destroyed, we can skip the remainder,
             // which handles fallout from the vehicle being damaged.
             continue;
@@ -7045,10 +7074,10 @@ void map::on_field_modified( const tripoint_bub_ms &p, const field_type &fd_type
     get_cache( p.z() ).field_cache.set(
         static_cast<size_t>( p.x() / SEEX ) + ( ( p.y() / SEEX ) * MAPSIZE ) );
 
-    // Dirty the transparency cache now that field processing doesn't always do it
+    // Dirty the transparency cache now that field processing doesn't always do it.
+    // The seen cache is only dirtied if the tile's transparency turns out to change.
     if( fd_type.dirty_transparency_cache || !fd_type.is_transparent() ) {
         set_transparency_cache_dirty( p, true );
-        set_seen_cache_dirty( p );
     }
 
     if( fd_type.is_dangerous() ) {
@@ -7787,8 +7816,6 @@ point map::sees_cache_key( const tripoint_bub_ms &from, const tripoint_bub_ms &t
 bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int range,
                 int &bresenham_slope, bool with_fields, bool allow_cached ) const
 {
-    bool ( map:: * f_transparent )( const tripoint_bub_ms & p ) const =
-        with_fields ? &map::is_transparent : &map::is_transparent_wo_fields;
     lru_cache_t &skew_cache = with_fields ? skew_vision_cache : skew_vision_wo_fields_cache;
     if( std::abs( F.z() - T.z() ) > fov_3d_z_range ||
         ( range >= 0 && range < rl_dist( F, T ) ) ||
@@ -7803,6 +7830,16 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
             return cached > 0;
         }
     }
+    const bool visible = sees_along_line( F, T, bresenham_slope, with_fields );
+    skew_cache.insert( 100000, key, visible ? 1 : 0 );
+    return visible;
+}
+
+bool map::sees_along_line( const tripoint_bub_ms &F, const tripoint_bub_ms &T,
+                           int &bresenham_slope, bool with_fields ) const
+{
+    bool ( map:: * f_transparent )( const tripoint_bub_ms & p ) const =
+        with_fields ? &map::is_transparent : &map::is_transparent_wo_fields;
     bool visible = true;
 
     // Ugly `if` for now
@@ -7819,7 +7856,6 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
             }
             return true;
         } );
-        skew_cache.insert( 100000, key, visible ? 1 : 0 );
         return visible;
     }
 
@@ -7852,10 +7888,37 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
         last_point = new_point;
         return true;
     } );
-    skew_cache.insert( 100000, key, visible ? 1 : 0 );
     return visible;
 }
 
+void map::cache_sight_lines( const std::vector<sight_line> &lines ) const
+{
+    std::vector<sight_line> todo;
+    std::vector<point> keys;
+    std::unordered_set<point> seen_keys;
+    for( const sight_line &line : lines ) {
+        // Lines between levels look at floors, which are not part of the map caches.
+        if( line.first.z() != line.second.z() || line.first == line.second ||
+            !inbounds( line.first ) || !inbounds( line.second ) ) {
+            continue;
+        }
+        const point key = sees_cache_key( line.first, line.second );
+        if( seen_keys.insert( key ).second && skew_vision_cache.get( key, -1 ) == -1 ) {
+            todo.push_back( line );
+            keys.push_back( key );
+        }
+    }
+
+    std::vector<char> visible( todo.size() );
+    cata::parallel_for( todo.size(), [&]( size_t i ) {
+        int bresenham_slope = 0;
+        visible[i] = sees_along_line( todo[i].first, todo[i].second, bresenham_slope, true ) ? 1 : 0;
+    } );
+    for( size_t i = 0; i < todo.size(); ++i ) {
+        skew_vision_cache.insert( 100000, keys[i], visible[i] );
+    }
+}
+
 int map::obstacle_coverage( const tripoint_bub_ms &loc1, const tripoint_bub_ms &loc2 ) const
 {
     // Can't hide if you are standing on furniture, or non-flat slowing-down terrain tile.
@@ -8444,6 +8507,8 @@ void map::shift( const point_rel_sm &sp )
     g->shift_destination_preview( { -sp.x() * SEEX, -sp.y() * SEEY } );
 
     shift_traps( sp );
+    // The cached temperatures are of the tiles that used to be at their coordinates.
+    get_weather().clear_temp_cache();
 
     vehicle *remoteveh = g->remoteveh();
 
@@ -10063,22 +10128,43 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
 {
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
+    const size_t num_levels = maxz - minz + 1;
     bool seen_cache_dirty = false;
     bool camera_cache_dirty = false;
+    // These passes only write the cache of their own z-level, so the levels are built at once.
+    // Any debug messages are reported afterwards, in z-level order.
+    std::vector<std::vector<deferred_debugmsg>> messages( num_levels );
+    std::vector<char> level_dirty( num_levels, false );
     for( int z = minz; z <= maxz; z++ ) {
-        build_outside_cache( z );
-        build_transparency_cache( z );
-        bool floor_cache_was_dirty = build_floor_cache( z );
-        seen_cache_dirty |= floor_cache_was_dirty;
-        seen_cache_dirty |= get_cache( z ).seen_cache_dirty;
+        // Allocate the caches up front rather than from the workers.
+        get_cache( z );
+    }
+    cata::parallel_for( num_levels, [&]( size_t i ) {
+        const int z = minz + static_cast<int>( i );
+        messages[i] = defer_debugmsgs_during( [&]() {
+            build_outside_cache( z );
+            build_transparency_cache( z );
+            level_dirty[i] = build_floor_cache( z );
+        } );
+    } );
+    for( size_t i = 0; i < num_levels; i++ ) {
+        replay_deferred_debugmsgs( messages[i] );
+        seen_cache_dirty |= level_dirty[i] || get_cache( minz + static_cast<int>( i ) ).seen_cache_dirty;
     }
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
     // otherwise such changes might be overwritten by main cache-building logic
     for( int z = minz; z <= maxz; z++ ) {
         do_vehicle_caching( z );
     }
-    for( int z = minz; z <= maxz; z++ ) {
-        seen_cache_dirty |= build_vision_transparency_cache( z );
+    cata::parallel_for( num_levels, [&]( size_t i ) {
+        const int z = minz + static_cast<int>( i );
+        messages[i] = defer_debugmsgs_during( [&]() {
+            level_dirty[i] = build_vision_transparency_cache( z );
+        } );
+    } );
+    for( size_t i = 0; i < num_levels; i++ ) {
+        replay_deferred_debugmsgs( messages[i] );
+        seen_cache_dirty |= level_dirty[i];
     }
 
     if( seen_cache_dirty ) {
@@ -10691,7 +10777,7 @@ void map::function_over( const tripoint_bub_ms &start, const tripoint_bub_ms &en
 
 void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &blocks_scent,
                           std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
-                          const point_bub_ms &min, const point_bub_ms &max )
+                          const point_bub_ms &min, const point_bub_ms &max, const int z )
 {
     ter_furn_flag reduce = ter_furn_flag::TFLAG_REDUCE_SCENT;
     ter_furn_flag block = ter_furn_flag::TFLAG_NO_SCENT;
@@ -10713,14 +10799,13 @@ void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &bl
         return ITER_CONTINUE;
     };
 
-    function_over( tripoint_bub_ms( min, abs_sub.z() ), tripoint_bub_ms( max, abs_sub.z() ),
-                   fill_values );
+    function_over( tripoint_bub_ms( min, z ), tripoint_bub_ms( max, z ), fill_values );
 
     const inclusive_rectangle<point_bub_ms> local_bounds( min, max );
 
     // Now vehicles
 
-    VehicleList vehs = get_vehicles();
+    VehicleList vehs = get_vehicles( tripoint_bub_ms( min, z ), tripoint_bub_ms( max, z ) );
     for( wrapped_vehicle &wrapped_veh : vehs ) {
         vehicle &veh = *( wrapped_veh.v );
         for( const vpart_reference &vp : veh.get_all_parts_with_fakes() ) {
@@ -10729,13 +10814,44 @@ void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &bl
                 continue;
             }
             const tripoint_bub_ms part_pos = vp.pos_bub();
-            if( local_bounds.contains( part_pos.xy() ) ) {
+            if( part_pos.z() == z && local_bounds.contains( part_pos.xy() ) ) {
                 reduces_scent[part_pos.x()][part_pos.y()] = true;
             }
         }
     }
 }
 
+void map::scent_vertical_links( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &links,
+                                const point_bub_ms &min, const point_bub_ms &max, const int z )
+{
+    // Stairs and ladders down, and holes in the floor, on the level above...
+    std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> no_floor_above = {};
+    function_over( tripoint_bub_ms( min, z + 1 ), tripoint_bub_ms( max, z + 1 ),
+    [&]( const tripoint_rel_sm & gp, const submap * sm, const point_sm_ms & lp ) {
+        const point_sm_ms p = lp + coords::project_to<coords::ms>( gp.xy() );
+        const ter_t &ter = sm->get_ter( lp ).obj();
+        links[p.x()][p.y()] = ter.has_flag( ter_furn_flag::TFLAG_GOES_DOWN ) ||
+                              sm->get_furn( lp ).obj().has_flag( ter_furn_flag::TFLAG_GOES_DOWN );
+        no_floor_above[p.x()][p.y()] = ter.has_flag( ter_furn_flag::TFLAG_NO_FLOOR );
+        return ITER_CONTINUE;
+    } );
+    // ...and stairs and ladders up from this level.  Open air over ground that is outdoors
+    // anyway is just the sky, scent does not rise into it.
+    function_over( tripoint_bub_ms( min, z ), tripoint_bub_ms( max, z ),
+    [&]( const tripoint_rel_sm & gp, const submap * sm, const point_sm_ms & lp ) {
+        const point_sm_ms p = lp + coords::project_to<coords::ms>( gp.xy() );
+        const ter_t &ter = sm->get_ter( lp ).obj();
+        const furn_t &furn = sm->get_furn( lp ).obj();
+        if( ter.has_flag( ter_furn_flag::TFLAG_GOES_UP ) ||
+            furn.has_flag( ter_furn_flag::TFLAG_GOES_UP ) ||
+            ( no_floor_above[p.x()][p.y()] && ( ter.has_flag( ter_furn_flag::TFLAG_INDOORS ) ||
+                                                furn.has_flag( ter_furn_flag::TFLAG_INDOORS ) ) ) ) {
+            links[p.x()][p.y()] = true;
+        }
+        return ITER_CONTINUE;
+    } );
+}
+
 tripoint_range<tripoint_bub_ms> map::points_in_rectangle( const tripoint_bub_ms &from,
         const tripoint_bub_ms &to ) const
 {
@@ -11050,10 +11166,16 @@ void map::update_pathfinding_cache( int zlev ) const
             }
         }
         cache.dirty = false;
+        routes->invalidate( zlev );
+        cache.portals.invalidate();
+        cache.portals_without_doors.invalidate();
     } else {
         for( const point_bub_ms &p : cache.dirty_points ) {
             update_pathfinding_cache( { p, zlev } );
+            cache.portals.invalidate( p );
+            cache.portals_without_doors.invalidate( p );
         }
+        routes->invalidate( zlev, cache.dirty_points );
     }
     cache.dirty_points.clear();
 }
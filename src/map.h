@@ -71,6 +71,7 @@ class relic_procgen_data;
 class submap;
 class vehicle;
 class zone_data;
+struct four_quadrants;
 struct fragment_cloud;
 struct partial_con;
 struct spawn_data;
@@ -97,6 +98,10 @@ class map;
 
 enum class ter_furn_flag : int;
 struct pathfinding_cache;
+class monster_path_avoid;
+class path_avoid_mask;
+class route_cache;
+struct flow_field;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
@@ -377,6 +382,7 @@ class map
         friend void field_processor_fd_fire_vent( const tripoint &, field_entry &, field_proc_data & );
         friend void field_processor_fd_flame_burst( const tripoint &, field_entry &, field_proc_data & );
         friend void field_processor_fd_incendiary( const tripoint &, field_entry &, field_proc_data & );
+        friend class field_spread_grid;
 
         // for testing
         friend void clear_fields( int zlevel );
@@ -579,7 +585,16 @@ class map
         void create_hot_air( const tripoint &p, int intensity );
         void create_hot_air( const tripoint_bub_ms &p, int intensity );
         bool gas_can_spread_to( field_entry &cur, const maptile &dst );
+        // Terrain and furniture let gas through.
+        static bool gas_can_enter( const maptile &dst );
         void gas_spread_to( field_entry &cur, maptile &dst, const tripoint_bub_ms &p );
+        /**
+         * Where the gas at p moves this turn, if it moves at all, by the rules of spread_gas.
+         * @param can_enter Whether the gas may move into the given tile.
+         */
+        std::optional<tripoint_bub_ms> gas_spread_target( const tripoint_bub_ms &p, int percent_spread,
+                int windpower, bool sheltered, int winddirection,
+                const std::function<bool( const tripoint_bub_ms &, const maptile & )> &can_enter );
         int burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp, int scale );
     public:
 
@@ -682,6 +697,14 @@ class map
         bool sees( const tripoint &F, const tripoint &T, int range, bool with_fields = true ) const;
         bool sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int range,
                    bool with_fields = true ) const;
+        /** From, to. */
+        using sight_line = std::pair<tripoint_bub_ms, tripoint_bub_ms>;
+        /**
+         * Works out on the worker pool whether each of the given lines of sight is clear, and
+         * stores the results in the cache @ref sees (with fields) answers from until the map
+         * caches change.  Lines already cached, and lines between levels, are left alone.
+         */
+        void cache_sight_lines( const std::vector<sight_line> &lines ) const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -696,6 +719,9 @@ class map
         bool sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int range, int &bresenham_slope,
                    bool with_fields = true, bool allow_cached = true ) const;
         point sees_cache_key( const tripoint_bub_ms &from, const tripoint_bub_ms &to ) const;
+        /** The uncached line of sight check of @ref sees, without the range checks. */
+        bool sees_along_line( const tripoint_bub_ms &F, const tripoint_bub_ms &T,
+                              int &bresenham_slope, bool with_fields ) const;
     public:
         /**
         * Returns coverage of target in relation to the observer. Target is loc2, observer is loc1.
@@ -774,12 +800,39 @@ class map
          * @param t The destination to which to path.
          * @param settings Structure describing pathfinding parameters.
          * @param pre_closed Never path through those points. They can still be the source or the destination.
+         *
+         * The search is confined to a box around f and t. If t can't be reached within it and
+         * the search ran into the edges of the box, a route on one z-level is planned across
+         * submaps instead (see portal_graph) and then searched for leg by leg.
          */
         std::vector<tripoint_bub_ms> route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
                                             const pathfinding_settings &settings,
         const std::function<bool( const tripoint_bub_ms & )> &avoid = []( const tripoint_bub_ms & ) {
             return false;
         } ) const;
+        /**
+         * As above, but the route may come from, or be kept in, a cache shared by all callers
+         * passing the same destination, settings and avoid_key during this turn.
+         * Equal keys promise that the avoid predicates give the same answer for every point as
+         * long as the pathfinding data of the map does not change, so only routes that stay on
+         * one z-level are shared.
+         * A caller standing on a route found earlier gets the rest of it without a new search,
+         * and once several callers converge on one destination a single search backwards from
+         * it (a flow field) answers all of them.
+         */
+        std::vector<tripoint_bub_ms> route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                            const pathfinding_settings &settings,
+                                            const std::function<bool( const tripoint_bub_ms & )> &avoid,
+                                            size_t avoid_key ) const;
+        // As above, for callers that worked out the points to avoid beforehand.
+        std::vector<tripoint_bub_ms> route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                            const pathfinding_settings &settings,
+                                            const path_avoid_mask &avoid ) const;
+        // As above, for monsters, with the avoid_key of monster::get_path_avoid_key().
+        std::vector<tripoint_bub_ms> route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                            const pathfinding_settings &settings,
+                                            const monster_path_avoid &avoid,
+                                            std::optional<size_t> avoid_key ) const;
 
         // Get a straight route from f to t, only along non-rough terrain. Returns an empty vector
         // if that is not possible.
@@ -788,6 +841,19 @@ class map
         std::vector<tripoint_bub_ms> straight_route( const tripoint_bub_ms &f,
                 const tripoint_bub_ms &t ) const;
     private:
+        // Avoid is called for every point the search looks at, so the search is compiled for
+        // each kind of avoid predicate rather than going through std::function.
+        template<typename Avoid>
+        std::vector<tripoint_bub_ms> find_route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                const pathfinding_settings &settings, const Avoid &avoid,
+                std::optional<size_t> avoid_key, bool use_portals = true ) const;
+        template<typename Avoid>
+        std::vector<tripoint_bub_ms> route_via_portals( const tripoint_bub_ms &f,
+                const tripoint_bub_ms &t, const pathfinding_settings &settings,
+                const Avoid &avoid ) const;
+        template<typename Avoid>
+        flow_field build_flow_field( const tripoint_bub_ms &t, const pathfinding_settings &settings,
+                                     const Avoid &avoid, size_t avoid_key ) const;
         // Pathfinding cost helper that computes the cost of moving into |p| from |cur|.
         // Includes climbing, bashing and opening doors.
         int cost_to_pass( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
@@ -1722,6 +1788,9 @@ class map
         // See fields.cpp
         void process_fields();
         void process_fields_in_submap( submap *current_submap, const tripoint_bub_sm &submap_pos );
+        // Takes the overmap terrain of the submap, so that it can run on a worker thread.
+        void process_fields_in_submap( submap *current_submap, const tripoint_bub_sm &submap_pos,
+                                       const oter_id &om_ter );
         /**
          * Apply field effects to the creature when it's on a square with fields.
          */
@@ -1893,13 +1962,19 @@ class map
 
         // Scent propagation helpers
         /**
-         * Build the map of scent-resistant tiles.
+         * Build the map of scent-resistant tiles on z-level z.
          * Should be way faster than if done in `game.cpp` using public map functions.
          */
         // TODO: make it typed.
         void scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &blocks_scent,
                              std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
-                             const point_bub_ms &min, const point_bub_ms &max );
+                             const point_bub_ms &min, const point_bub_ms &max, int z );
+        /**
+         * Marks the tiles of z-level z through which scent passes to the level above:
+         * stairs and ladders between the two, and holes in the floor above indoor tiles.
+         */
+        void scent_vertical_links( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &links,
+                                   const point_bub_ms &min, const point_bub_ms &max, int z );
 
         // Computers
         computer *computer_at( const tripoint_bub_ms &p );
@@ -2387,6 +2462,11 @@ class map
         int determine_wall_corner( const tripoint_bub_ms &p ) const;
         // apply a circular light pattern immediately, however it's best to use...
         void apply_light_source( const tripoint_bub_ms &p, float luminance );
+        // As above, but lighting up lm and sm rather than the caches of p's z-level, so
+        // that sources can be cast concurrently and merged afterwards.
+        void apply_light_source( const tripoint_bub_ms &p, float luminance,
+                                 cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                                 cata::mdarray<float, point_bub_ms> &sm ) const;
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint_bub_ms &p, float luminance );
@@ -2469,6 +2549,7 @@ class map
         mutable std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        mutable std::unique_ptr<route_cache> routes;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
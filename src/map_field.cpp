@@ -19,7 +19,10 @@
 
 #include "avatar.h"
 #include "bodypart.h"
+#include "cached_options.h"
 #include "calendar.h"
+#include "cata_scope_helpers.h"
+#include "cata_thread_pool.h"
 #include "cata_utility.h"
 #include "character.h"
 #include "colony.h"
@@ -32,6 +35,7 @@
 #include "emit.h"
 #include "enums.h"
 #include "field.h"
+#include "field_spread_grid.h"
 #include "field_type.h"
 #include "fire.h"
 #include "fungal_effects.h"
@@ -164,8 +168,70 @@ int map::burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp
     return total_damage;
 }
 
+namespace
+{
+
+// A submap whose fields are processed on a worker thread, see map::process_fields.
+// Changes that reach into other submaps, or into caches shared by the whole map, are
+// recorded here and applied after every submap of the same color is done.
+struct concurrent_field_pass {
+    struct gas_spread {
+        tripoint_bub_ms p;
+        field_type_id type;
+        time_duration age;
+    };
+
+    submap *sm;
+    tripoint_bub_sm pos;
+    oter_id om_ter;
+    cata_default_random_engine engine;
+    std::vector<gas_spread> spreads;
+    std::vector<std::pair<tripoint_bub_ms, field_type_id>> modified;
+    std::optional<scent_block> scent;
+    // Whether each tile of the submap is sheltered, see game::is_sheltered.  Found on the main
+    // thread, as vehicles work out which of their parts are inside only when first asked.  Gas
+    // spreading within the submap is processed in the same pass, so every tile is needed.
+    std::bitset<SEEX * SEEY> sheltered;
+    // Set when a field was added on the player's tile, which hits them once the pass is done.
+    bool hit_player = false;
+
+    bool is_sheltered( const tripoint_bub_ms &p ) const {
+        const point_bub_ms origin = coords::project_to<coords::ms>( pos.xy() );
+        return sheltered[( p.x() - origin.x() ) + ( p.y() - origin.y() ) * SEEX];
+    }
+};
+
+thread_local concurrent_field_pass *current_field_pass = nullptr;
+
+} // namespace
+
+static bool fields_are_local( const submap &sm )
+{
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            const field &curfield = sm.get_field( { x, y } );
+            if( !curfield.displayed_field_type() ) {
+                continue;
+            }
+            for( const std::pair<const field_type_id, field_entry> &fd : curfield ) {
+                if( !fd.first->has_local_processing() ) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
 void map::process_fields()
 {
+    if( gas_spread_grid ) {
+        field_spread_grid::spread_gases( *this );
+    }
+
+    // Submaps whose fields only affect their own tiles and the fields next to them (mostly
+    // gas) are left for later, everything else is processed here in the usual order.
+    std::vector<std::pair<submap *, tripoint_bub_sm>> local;
     for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
         auto &field_cache = get_cache( z ).field_cache;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
@@ -176,6 +242,10 @@ void map::process_fields()
                         debugmsg( "Tried to process field at (%d,%d,%d) but the submap is not loaded", x, y, z );
                         continue;
                     }
+                    if( fields_are_local( *current_submap ) ) {
+                        local.emplace_back( current_submap, tripoint_bub_sm{ x, y, z } );
+                        continue;
+                    }
                     process_fields_in_submap( current_submap, { x, y, z } );
                     if( current_submap->field_count == 0 ) {
                         field_cache[ x + y * MAPSIZE ] = false;
@@ -184,6 +254,75 @@ void map::process_fields()
             }
         }
     }
+
+    // The remaining submaps are split into eight colors by the parity of their coordinates,
+    // so that no two submaps of a color touch, not even diagonally or across z-levels.  Each
+    // color is processed concurrently, and the spreads into neighboring submaps are applied
+    // in a fixed order once it is done.  Every submap draws from its own engine, seeded here,
+    // so the result is the same no matter how many threads there are.
+    std::array<std::vector<concurrent_field_pass>, 8> colors;
+    for( const std::pair<submap *, tripoint_bub_sm> &sm : local ) {
+        const tripoint_bub_sm &pos = sm.second;
+        // Fields might have been added or removed by the submaps processed above.
+        const bool processed = sm.first->field_count != 0 && !fields_are_local( *sm.first );
+        if( processed ) {
+            process_fields_in_submap( sm.first, pos );
+        }
+        if( sm.first->field_count == 0 ) {
+            get_cache( pos.z() ).field_cache[ pos.x() + pos.y() * MAPSIZE ] = false;
+        }
+        if( processed || sm.first->field_count == 0 ) {
+            continue;
+        }
+        const int color = pos.x() % 2 + pos.y() % 2 * 2 + ( pos.z() + OVERMAP_DEPTH ) % 2 * 4;
+        concurrent_field_pass &pass = colors[color].emplace_back( concurrent_field_pass{
+            sm.first, pos,
+            overmap_buffer.ter( coords::project_to<coords::omt>( abs_sub + rebase_rel( pos ) ) ),
+            cata_default_random_engine( rng_bits() ), {}, {}, std::nullopt, {}, false
+        } );
+        const point_bub_ms origin = coords::project_to<coords::ms>( pos.xy() );
+        for( int x = 0; x < SEEX; x++ ) {
+            for( int y = 0; y < SEEY; y++ ) {
+                pass.sheltered[x + y * SEEX] =
+                    g->is_sheltered( tripoint_bub_ms( origin + point( x, y ), pos.z() ) );
+            }
+        }
+    }
+
+    for( std::vector<concurrent_field_pass> &passes : colors ) {
+        cata::parallel_for( passes.size(), [this, &passes]( size_t i ) {
+            concurrent_field_pass &pass = passes[i];
+            restore_on_out_of_scope restore_pass( current_field_pass );
+            scoped_rng_engine use_engine( pass.engine );
+            current_field_pass = &pass;
+            process_fields_in_submap( pass.sm, pass.pos, pass.om_ter );
+        } );
+        for( concurrent_field_pass &pass : passes ) {
+            for( const concurrent_field_pass::gas_spread &spread : pass.spreads ) {
+                maptile dst = maptile_at_internal( spread.p );
+                if( field_entry *f = dst.find_field( spread.type ) ) {
+                    f->set_field_intensity( f->get_field_intensity() + 1 );
+                    f->set_field_age( f->get_field_age() + spread.age );
+                } else if( add_field( spread.p, spread.type, 1, 0_turns ) ) {
+                    if( field_entry *added = dst.find_field( spread.type ) ) {
+                        added->set_field_age( spread.age );
+                    }
+                }
+            }
+            for( const std::pair<tripoint_bub_ms, field_type_id> &modified : pass.modified ) {
+                on_field_modified( modified.first, *modified.second );
+            }
+            if( pass.hit_player && this == &get_map() ) {
+                creature_in_field( get_player_character() );
+            }
+            if( pass.scent ) {
+                pass.scent->commit_modifications();
+            }
+            if( pass.sm->field_count == 0 ) {
+                get_cache( pass.pos.z() ).field_cache[ pass.pos.x() + pass.pos.y() * MAPSIZE ] = false;
+            }
+        }
+    }
 }
 
 bool ter_furn_has_flag( const ter_t &ter, const furn_t &furn, const ter_furn_flag flag )
@@ -273,14 +412,19 @@ bool map::gas_can_spread_to( field_entry &cur, const maptile &dst )
     const field_entry *tmpfld = dst.get_field().find_field( cur.get_field_type() );
     // Candidates are existing weaker fields or navigable/flagged tiles with no field.
     if( tmpfld == nullptr || tmpfld->get_field_intensity() < cur.get_field_intensity() ) {
-        const ter_t &ter = dst.get_ter_t();
-        const furn_t &frn = dst.get_furn_t();
-        return ter_furn_movecost( ter, frn ) > 0 ||
-               ter_furn_has_flag( ter, frn, ter_furn_flag::TFLAG_PERMEABLE );
+        return gas_can_enter( dst );
     }
     return false;
 }
 
+bool map::gas_can_enter( const maptile &dst )
+{
+    const ter_t &ter = dst.get_ter_t();
+    const furn_t &frn = dst.get_furn_t();
+    return ter_furn_movecost( ter, frn ) > 0 ||
+           ter_furn_has_flag( ter, frn, ter_furn_flag::TFLAG_PERMEABLE );
+}
+
 void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint_bub_ms &p )
 {
     const field_type_id current_type = cur.get_field_type();
@@ -289,11 +433,31 @@ void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint_bub_ms &
     field_entry *f = dst.find_field( current_type );
     // Nearby gas grows thicker, and ages are shared.
     const time_duration age_fraction = current_age / current_intensity;
-    if( f != nullptr ) {
+    if( current_field_pass != nullptr && dst.wrapped_submap() != current_field_pass->sm ) {
+        // Other submaps are not ours to change while processing concurrently.
+        current_field_pass->spreads.push_back( { p, current_type, age_fraction } );
+        cur.set_field_intensity( current_intensity - 1 );
+        cur.set_field_age( current_age - age_fraction );
+    } else if( f != nullptr ) {
         f->set_field_intensity( f->get_field_intensity() + 1 );
         cur.set_field_intensity( current_intensity - 1 );
         f->set_field_age( f->get_field_age() + age_fraction );
         cur.set_field_age( current_age - age_fraction );
+    } else if( current_field_pass != nullptr ) {
+        // Same as below, but the caches add_field updates are shared with the other threads,
+        // and hitting the player with the new field waits until the pass is done.
+        if( dst.wrapped_submap()->get_field( dst.pos() ).add_field( current_type, 1, 0_turns ) ) {
+            ++dst.wrapped_submap()->field_count;
+        }
+        current_field_pass->modified.emplace_back( p, current_type );
+        if( p == get_player_character().pos_bub() ) {
+            current_field_pass->hit_player = true;
+        }
+        if( field_entry *added = dst.find_field( current_type ) ) {
+            added->set_field_age( age_fraction );
+        }
+        cur.set_field_intensity( current_intensity - 1 );
+        cur.set_field_age( current_age - age_fraction );
         // Or, just create a new field.
     } else if( add_field( p, current_type, 1, 0_turns ) ) {
         f = dst.find_field( current_type );
@@ -317,7 +481,8 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
                       const time_duration &outdoor_age_speedup, scent_block &sblk, const oter_id &om_ter )
 {
     // TODO: fix point types
-    const bool sheltered = g->is_sheltered( p );
+    const bool sheltered = current_field_pass != nullptr ? current_field_pass->is_sheltered( p ) :
+                           g->is_sheltered( p );
     weather_manager &weather = get_weather();
     const int winddirection = weather.winddirection;
     const int windpower = get_local_windpower( weather.windspeed, om_ter, getglobal( p ),
@@ -343,19 +508,41 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
         cur.set_field_age( current_age + outdoor_age_speedup );
     }
 
-    // Bail out if we don't meet the spread chance or required intensity.
-    if( current_intensity <= 1 || rng( 1, 100 - windpower ) > percent_spread ) {
+    // The gas of the whole map was already moved by field_spread_grid.
+    if( gas_spread_grid ) {
         return;
     }
 
+    // Bail out if we don't meet the required intensity.
+    if( current_intensity <= 1 ) {
+        return;
+    }
+
+    const std::optional<tripoint_bub_ms> target = gas_spread_target( p, percent_spread, windpower,
+            sheltered, winddirection, [this, &cur]( const tripoint_bub_ms &, const maptile & dst ) {
+        return gas_can_spread_to( cur, dst );
+    } );
+    if( target ) {
+        maptile dst = maptile_at_internal( *target );
+        gas_spread_to( cur, dst, *target );
+    }
+}
+
+std::optional<tripoint_bub_ms> map::gas_spread_target( const tripoint_bub_ms &p,
+        const int percent_spread, const int windpower, const bool sheltered, const int winddirection,
+        const std::function<bool( const tripoint_bub_ms &, const maptile & )> &can_enter )
+{
+    // Bail out if we don't meet the spread chance.
+    if( rng( 1, 100 - windpower ) > percent_spread ) {
+        return std::nullopt;
+    }
+
     // First check if we can fall
     // TODO: Make fall and rise chances parameters to enable heavy/light gas
     if( p.z() > -OVERMAP_DEPTH ) {
         const tripoint_bub_ms down = p + tripoint_rel_ms::below;
-        maptile down_tile = maptile_at_internal( down );
-        if( gas_can_spread_to( cur, down_tile ) && valid_move( p, down, true, true ) ) {
-            gas_spread_to( cur, down_tile, down );
-            return;
+        if( can_enter( down, maptile_at_internal( down ) ) && valid_move( p, down, true, true ) ) {
+            return down;
         }
     }
 
@@ -370,7 +557,7 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
          count != neighs.size();
          i = ( i + 1 ) % neighs.size(), count++ ) {
         const auto &neigh = neighs[i];
-        if( gas_can_spread_to( cur, neigh.second ) ) {
+        if( can_enter( neigh.first, neigh.second ) ) {
             spread.push_back( i );
         }
     }
@@ -378,36 +565,33 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
     if( !spread.empty() && one_in( spread.size() ) ) {
         // Construct the destination from offset and p
         if( sheltered || windpower < 5 ) {
-            std::pair<tripoint_bub_ms, maptile> &n = neighs[ random_entry( spread ) ];
-            gas_spread_to( cur, n.second, n.first );
-        } else {
-            std::vector<size_t> neighbour_vec;
-            auto maptiles = get_wind_blockers( winddirection, p );
-            // Three map tiles that are facing the wind direction.
-            const maptile &remove_tile = std::get<0>( maptiles );
-            const maptile &remove_tile2 = std::get<1>( maptiles );
-            const maptile &remove_tile3 = std::get<2>( maptiles );
-            for( const size_t &i : spread ) {
-                const maptile &neigh = neighs[i].second;
-                if( ( neigh.pos_ != remove_tile.pos_ &&
-                      neigh.pos_ != remove_tile2.pos_ &&
-                      neigh.pos_ != remove_tile3.pos_ ) ||
-                    x_in_y( 1, std::max( 2, windpower ) ) ) {
-                    neighbour_vec.push_back( i );
-                }
-            }
-            if( !neighbour_vec.empty() ) {
-                std::pair<tripoint_bub_ms, maptile> &n = neighs[ random_entry( neighbour_vec ) ];
-                gas_spread_to( cur, n.second, n.first );
-            }
+            return neighs[ random_entry( spread ) ].first;
+        }
+        std::vector<size_t> neighbour_vec;
+        auto maptiles = get_wind_blockers( winddirection, p );
+        // Three map tiles that are facing the wind direction.
+        const maptile &remove_tile = std::get<0>( maptiles );
+        const maptile &remove_tile2 = std::get<1>( maptiles );
+        const maptile &remove_tile3 = std::get<2>( maptiles );
+        for( const size_t &i : spread ) {
+            const maptile &neigh = neighs[i].second;
+            if( ( neigh.pos_ != remove_tile.pos_ &&
+                  neigh.pos_ != remove_tile2.pos_ &&
+                  neigh.pos_ != remove_tile3.pos_ ) ||
+                x_in_y( 1, std::max( 2, windpower ) ) ) {
+                neighbour_vec.push_back( i );
+            }
+        }
+        if( !neighbour_vec.empty() ) {
+            return neighs[ random_entry( neighbour_vec ) ].first;
         }
     } else if( p.z() < OVERMAP_HEIGHT ) {
         const tripoint_bub_ms up = p + tripoint_rel_ms::above;
-        maptile up_tile = maptile_at_internal( up );
-        if( gas_can_spread_to( cur, up_tile ) && valid_move( p, up, true, true ) ) {
-            gas_spread_to( cur, up_tile, up );
+        if( can_enter( up, maptile_at_internal( up ) ) && valid_move( p, up, true, true ) ) {
+            return up;
         }
     }
+    return std::nullopt;
 }
 
 /*
@@ -470,8 +654,21 @@ void map::process_fields_in_submap( submap *const current_submap,
 {
     const oter_id &om_ter = overmap_buffer.ter( coords::project_to<coords::omt>(
                                 abs_sub + rebase_rel( submap ) ) );
+    process_fields_in_submap( current_submap, submap, om_ter );
+}
+
+void map::process_fields_in_submap( submap *const current_submap,
+                                    const tripoint_bub_sm &submap, const oter_id &om_ter )
+{
     Character &player_character = get_player_character();
     scent_block sblk( submap.raw(), get_scent() );
+    const auto field_modified = [this]( const tripoint_bub_ms & p, const field_type_id & type ) {
+        if( current_field_pass != nullptr ) {
+            current_field_pass->modified.emplace_back( p, type );
+        } else {
+            on_field_modified( p, *type );
+        }
+    };
 
     // Initialize the map tile wrapper
     maptile map_tile( current_submap, point_sm_ms::zero );
@@ -515,7 +712,7 @@ void map::process_fields_in_submap( submap *const current_submap,
 
                 // The field might have been killed by processing a neighbor field
                 if( prev_intensity == 0 ) {
-                    on_field_modified( p, *pd.cur_fd_type );
+                    field_modified( p, pd.cur_fd_type_id );
                     --current_submap->field_count;
                     curfield.remove_field( it++ );
                     continue;
@@ -525,7 +722,7 @@ void map::process_fields_in_submap( submap *const current_submap,
                 if( cur.get_field_age() == 0_turns ) {
                     cur.do_decay();
                     if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
-                        on_field_modified( p, *pd.cur_fd_type );
+                        field_modified( p, pd.cur_fd_type_id );
                     }
                     it++;
                     continue;
@@ -537,13 +734,19 @@ void map::process_fields_in_submap( submap *const current_submap,
 
                 cur.do_decay();
                 if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
-                    on_field_modified( p, *pd.cur_fd_type );
+                    field_modified( p, pd.cur_fd_type_id );
                 }
                 it++;
             }
         }
     }
-    sblk.commit_modifications();
+    if( current_field_pass != nullptr ) {
+        if( sblk.modification_count != 0 ) {
+            current_field_pass->scent.emplace( sblk );
+        }
+    } else {
+        sblk.commit_modifications();
+    }
 }
 
 static void field_processor_upgrade_intensity( const tripoint &, field_entry &cur,
@@ -2335,6 +2538,15 @@ std::vector<FieldProcessorPtr> map_field_processing::processors_for_type( const
     return processors;
 }
 
+bool map_field_processing::processors_are_local( const std::vector<FieldProcessorPtr> &processors )
+{
+    return std::all_of( processors.begin(), processors.end(), []( FieldProcessorPtr proc ) {
+        return proc == &field_processor_upgrade_intensity ||
+               proc == &field_processor_underwater_dissipation ||
+               proc == &field_processor_spread_gas;
+    } );
+}
+
 const field_type_str_id &map::get_applicable_electricity_field( const tripoint_bub_ms &p ) const
 {
     return is_transparent( p ) ? fd_electricity : fd_electricity_unlit;
@@ -21,6 +21,13 @@ using FieldProcessorPtr = void( * )( const tripoint &p, field_entry &cur, field_
  */
 std::vector<FieldProcessorPtr> processors_for_type( const field_type &ft );
 
+/**
+ * True if none of the processors has effects beyond the fields of the processed tile and its
+ * neighbors (no fire, items, creatures, terrain or radiation), which lets submaps holding
+ * only such fields be processed concurrently, see map::process_fields
+ */
+bool processors_are_local( const std::vector<FieldProcessorPtr> &processors );
+
 } // namespace map_field_processing
 
 #endif // CATA_SRC_MAP_FIELD_H
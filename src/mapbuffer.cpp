@@ -1,10 +1,14 @@
 #include "mapbuffer.h"
 
 #include <chrono>
+#include <cstdio>
 #include <exception>
 #include <filesystem>
+#include <fstream>
+#include <optional>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -14,6 +18,7 @@
 #include "filesystem.h"
 #include "input.h"
 #include "json.h"
+#include "json_loader.h"
 #include "map.h"
 #include "output.h"
 #include "overmapbuffer.h"
@@ -37,6 +42,11 @@ static cata_path find_quad_path( const cata_path &dirname, const tripoint_abs_om
     return dirname / string_format( "%d.%d.%d.map", om_addr.x(), om_addr.y(), om_addr.z() );
 }
 
+static cata_path find_pack_path( const cata_path &dirname )
+{
+    return dirname / "quads.pack";
+}
+
 static cata_path find_dirname( const tripoint_abs_omt &om_addr )
 {
     const tripoint_abs_seg segment_addr = project_to<coords::seg>( om_addr );
@@ -45,6 +55,309 @@ static cata_path find_dirname( const tripoint_abs_omt &om_addr )
             segment_addr.y(), segment_addr.z() );
 }
 
+namespace
+{
+
+struct pack_entry {
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+} // namespace
+
+/**
+ * The quads of one segment directory, kept as records appended to a single file together with
+ * an index of where the latest record of each quad starts.  An autosave therefore appends to a
+ * few files and rewrites their small indexes, instead of rewriting a file for every quad.
+ *
+ * A record is a line "x y z length" followed by length bytes of the json a quad file holds; a
+ * record of length 0 marks a quad that is no longer stored.  The index remembers how much of the
+ * file it covers, so records appended by a save that stopped before the index was written are
+ * found again by reading the rest of the file.
+ */
+class submap_region_pack
+{
+    public:
+        explicit submap_region_pack( const cata_path &dirname );
+
+        const cata_path &directory() const {
+            return dirname;
+        }
+        bool contains( const tripoint_abs_omt &om_addr ) const {
+            return index.count( om_addr ) != 0;
+        }
+        /** The json of the quad, or nothing if it is not in the pack. */
+        std::optional<std::string> read( const tripoint_abs_omt &om_addr ) const;
+
+        /** Remembers that the quad was read from the file it had to itself in older saves. */
+        void add_legacy_file( const tripoint_abs_omt &om_addr, const cata_path &path );
+        bool has_legacy_file( const tripoint_abs_omt &om_addr ) const {
+            return legacy_files.count( om_addr ) != 0;
+        }
+
+        /** Queues the quad to be written by the next flush(). */
+        void stage( const tripoint_abs_omt &om_addr, std::string json );
+        /** Queues the removal of the quad. */
+        void stage_removal( const tripoint_abs_omt &om_addr );
+        size_t staged_size() const {
+            return staged_bytes;
+        }
+        /** Appends everything queued, then rewrites the index. */
+        void flush();
+
+    private:
+        void load_index();
+        void scan( const std::string &data, size_t from, size_t base );
+        void write_index() const;
+        void compact();
+        std::string read_pack( size_t from ) const;
+
+        cata_path dirname;
+        cata_path pack_path;
+        cata_path index_path;
+        std::map<tripoint_abs_omt, pack_entry> index;
+        // Length of the valid part of the pack file.
+        size_t pack_size = 0;
+        std::vector<std::pair<tripoint_abs_omt, std::string>> staged;
+        size_t staged_bytes = 0;
+        std::map<tripoint_abs_omt, cata_path> legacy_files;
+};
+
+submap_region_pack::submap_region_pack( const cata_path &dirname ) : dirname( dirname ),
+    pack_path( find_pack_path( dirname ) ), index_path( dirname / "quads.idx" )
+{
+    load_index();
+}
+
+std::string submap_region_pack::read_pack( size_t from ) const
+{
+    std::ifstream fin( pack_path.get_unrelative_path(), std::ios::binary );
+    if( !fin ) {
+        return std::string();
+    }
+    fin.seekg( 0, std::ios::end );
+    const std::streamoff end = fin.tellg();
+    if( end < 0 || static_cast<size_t>( end ) <= from ) {
+        return std::string();
+    }
+    std::string data( static_cast<size_t>( end ) - from, '\0' );
+    fin.seekg( static_cast<std::streamoff>( from ) );
+    fin.read( &data[0], static_cast<std::streamsize>( data.size() ) );
+    data.resize( static_cast<size_t>( fin.gcount() ) );
+    return data;
+}
+
+void submap_region_pack::load_index()
+{
+    index.clear();
+    pack_size = 0;
+    if( !file_exist( pack_path ) ) {
+        return;
+    }
+    bool index_valid = false;
+    try {
+        index_valid = read_from_file_optional_json( index_path, [this]( const JsonValue & jv ) {
+            JsonObject jo = jv;
+            pack_size = static_cast<size_t>( jo.get_member( "pack_size" ).get_uint64() );
+            for( JsonArray quad : jo.get_array( "quads" ) ) {
+                const tripoint_abs_omt om_addr( quad.get_int( 0 ), quad.get_int( 1 ), quad.get_int( 2 ) );
+                index[om_addr] = pack_entry{ static_cast<size_t>( quad[3].get_uint64() ),
+                                             static_cast<size_t>( quad[4].get_uint64() ) };
+            }
+        } );
+    } catch( const std::exception &err ) {
+        debugmsg( "Rebuilding the unreadable map index %s: %s", index_path.generic_u8string(),
+                  err.what() );
+        index_valid = false;
+    }
+    const size_t file_size = fs::file_size( pack_path.get_unrelative_path() );
+    if( !index_valid || file_size < pack_size ) {
+        index.clear();
+        pack_size = 0;
+    }
+    if( file_size > pack_size ) {
+        scan( read_pack( pack_size ), 0, pack_size );
+    }
+}
+
+void submap_region_pack::scan( const std::string &data, size_t from, size_t base )
+{
+    size_t pos = from;
+    while( pos < data.size() ) {
+        const size_t eol = data.find( '\n', pos );
+        if( eol == std::string::npos || eol - pos > 64 ) {
+            break;
+        }
+        // Parse a copy of the line, sscanf may look at the whole rest of the buffer otherwise.
+        const std::string header = data.substr( pos, eol - pos );
+        int x = 0;
+        int y = 0;
+        int z = 0;
+        unsigned long long length = 0;
+        if( std::sscanf( header.c_str(), "%d %d %d %llu", &x, &y, &z, &length ) != 4 ||
+            length > data.size() - eol - 1 ) {
+            break;
+        }
+        const tripoint_abs_omt om_addr( x, y, z );
+        if( length == 0 ) {
+            index.erase( om_addr );
+        } else {
+            index[om_addr] = pack_entry{ base + eol + 1, static_cast<size_t>( length ) };
+        }
+        pos = eol + 1 + length;
+    }
+    // Anything after the last complete record is cut off by the next flush.
+    pack_size = base + pos;
+}
+
+std::optional<std::string> submap_region_pack::read( const tripoint_abs_omt &om_addr ) const
+{
+    const auto it = index.find( om_addr );
+    if( it == index.end() ) {
+        return std::nullopt;
+    }
+    std::ifstream fin( pack_path.get_unrelative_path(), std::ios::binary );
+    std::string json( it->second.length, '\0' );
+    fin.seekg( static_cast<std::streamoff>( it->second.offset ) );
+    fin.read( &json[0], static_cast<std::streamsize>( json.size() ) );
+    if( !fin ) {
+        debugmsg( "Failed to read map quad %s from %s", om_addr.to_string(),
+                  pack_path.generic_u8string() );
+        return std::nullopt;
+    }
+    return json;
+}
+
+void submap_region_pack::add_legacy_file( const tripoint_abs_omt &om_addr, const cata_path &path )
+{
+    legacy_files.emplace( om_addr, path );
+}
+
+void submap_region_pack::stage( const tripoint_abs_omt &om_addr, std::string json )
+{
+    staged_bytes += json.size();
+    staged.emplace_back( om_addr, std::move( json ) );
+}
+
+void submap_region_pack::stage_removal( const tripoint_abs_omt &om_addr )
+{
+    staged.emplace_back( om_addr, std::string() );
+}
+
+void submap_region_pack::flush()
+{
+    if( staged.empty() ) {
+        return;
+    }
+    assure_dir_exist( dirname );
+    const fs::path path = pack_path.get_unrelative_path();
+    if( !fs::exists( path ) ) {
+        index.clear();
+        pack_size = 0;
+    } else if( fs::file_size( path ) != pack_size ) {
+        // Drop whatever an interrupted save left after the last complete record.
+        fs::resize_file( path, pack_size );
+    }
+
+    std::vector<std::pair<tripoint_abs_omt, pack_entry>> written;
+    written.reserve( staged.size() );
+    size_t pos = pack_size;
+    {
+        std::ofstream fout( path, std::ios::binary | std::ios::app );
+        for( const std::pair<tripoint_abs_omt, std::string> &quad : staged ) {
+            const std::string header = string_format( "%d %d %d %d\n", quad.first.x(),
+                                       quad.first.y(), quad.first.z(), quad.second.size() );
+            fout << header << quad.second;
+            pos += header.size();
+            written.emplace_back( quad.first, pack_entry{ pos, quad.second.size() } );
+            pos += quad.second.size();
+        }
+        fout.close();
+        if( !fout ) {
+            throw std::runtime_error( string_format( "failed to write %s",
+                                      pack_path.generic_u8string() ) );
+        }
+    }
+    pack_size = pos;
+    for( const std::pair<tripoint_abs_omt, pack_entry> &quad : written ) {
+        if( quad.second.length == 0 ) {
+            index.erase( quad.first );
+        } else {
+            index[quad.first] = quad.second;
+        }
+        // The pack takes precedence, so the old file would just be left behind.
+        const auto legacy = legacy_files.find( quad.first );
+        if( legacy != legacy_files.end() ) {
+            remove_file( legacy->second );
+            legacy_files.erase( legacy );
+        }
+    }
+    staged.clear();
+    staged_bytes = 0;
+
+    size_t live_size = 0;
+    for( const std::pair<const tripoint_abs_omt, pack_entry> &entry : index ) {
+        live_size += entry.second.length;
+    }
+    // Records replaced by later ones are dead weight; rewrite the pack once they dominate it.
+    static constexpr size_t compact_threshold = 1024 * 1024;
+    if( pack_size > compact_threshold && pack_size > 2 * live_size ) {
+        compact();
+    } else {
+        write_index();
+    }
+}
+
+void submap_region_pack::compact()
+{
+    const std::string data = read_pack( 0 );
+    std::map<tripoint_abs_omt, pack_entry> compacted;
+    // The offsets of the old index are meaningless in the new file; without an index the next
+    // load reads the whole pack instead.
+    remove_file( index_path );
+    size_t pos = 0;
+    write_to_file( pack_path, [&]( std::ostream & fout ) {
+        for( const std::pair<const tripoint_abs_omt, pack_entry> &entry : index ) {
+            if( entry.second.offset + entry.second.length > data.size() ) {
+                continue;
+            }
+            const std::string header = string_format( "%d %d %d %d\n", entry.first.x(),
+                                       entry.first.y(), entry.first.z(), entry.second.length );
+            fout << header;
+            fout.write( data.data() + entry.second.offset,
+                        static_cast<std::streamsize>( entry.second.length ) );
+            pos += header.size();
+            compacted[entry.first] = pack_entry{ pos, entry.second.length };
+            pos += entry.second.length;
+        }
+    } );
+    index = std::move( compacted );
+    pack_size = pos;
+    write_index();
+}
+
+void submap_region_pack::write_index() const
+{
+    write_to_file( index_path, [this]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_object();
+        jsout.member( "pack_size", pack_size );
+        jsout.member( "quads" );
+        jsout.start_array();
+        for( const std::pair<const tripoint_abs_omt, pack_entry> &entry : index ) {
+            jsout.start_array();
+            jsout.write( entry.first.x() );
+            jsout.write( entry.first.y() );
+            jsout.write( entry.first.z() );
+            jsout.write( entry.second.offset );
+            jsout.write( entry.second.length );
+            jsout.end_array();
+        }
+        jsout.end_array();
+        jsout.end_object();
+    } );
+}
+
 mapbuffer MAPBUFFER;
 
 mapbuffer::mapbuffer() = default;
@@ -53,6 +366,7 @@ mapbuffer::~mapbuffer() = default;
 void mapbuffer::clear()
 {
     submaps.clear();
+    region_packs.clear();
 }
 
 void mapbuffer::clear_outside_reality_bubble()
@@ -134,6 +448,18 @@ bool mapbuffer::submap_exists( const tripoint_abs_sm &p )
     return true;
 }
 
+submap_region_pack &mapbuffer::region_pack( const tripoint_abs_omt &om_addr )
+{
+    const tripoint_abs_seg segment_addr = project_to<coords::seg>( om_addr );
+    const cata_path dirname = find_dirname( om_addr );
+    std::unique_ptr<submap_region_pack> &pack = region_packs[segment_addr];
+    // The world may have changed since the pack was opened.
+    if( !pack || !( pack->directory() == dirname ) ) {
+        pack = std::make_unique<submap_region_pack>( dirname );
+    }
+    return *pack;
+}
+
 void mapbuffer::save( bool delete_after_save )
 {
     assure_dir_exist( PATH_INFO::world_base_save_path() / "maps" );
@@ -148,6 +474,10 @@ void mapbuffer::save( bool delete_after_save )
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint_abs_omt> saved_submaps;
     std::list<tripoint_abs_sm> submaps_to_delete;
+    std::set<submap_region_pack *> staged_packs;
+    // Serialized quads are held back so each segment file gets one large append, but not
+    // without limit.
+    static constexpr size_t max_staged_size = 4 * 1024 * 1024;
     static constexpr std::chrono::milliseconds update_interval( 500 );
     std::chrono::steady_clock::time_point last_update = std::chrono::steady_clock::now();
 
@@ -172,27 +502,30 @@ void mapbuffer::save( bool delete_after_save )
         }
         saved_submaps.insert( om_addr );
 
-        // A segment is a chunk of 32x32 submap quads.
-        // We're breaking them into subdirectories so there aren't too many files per directory.
-        // Might want to make a set for this one too so it's only checked once per save().
-        const cata_path dirname = find_dirname( om_addr );
-        const cata_path quad_path = find_quad_path( dirname, om_addr );
+        // A segment is a chunk of 32x32 submap quads, stored together in one file.
+        submap_region_pack &pack = region_pack( om_addr );
 
         bool inside_reality_bubble = here.inbounds( om_addr );
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
-                   delete_after_save || !inside_reality_bubble );
+        save_quad( pack, om_addr, submaps_to_delete, delete_after_save || !inside_reality_bubble );
+        if( pack.staged_size() > max_staged_size ) {
+            pack.flush();
+        } else {
+            staged_packs.insert( &pack );
+        }
         num_saved_submaps += 4;
     }
+    for( submap_region_pack *pack : staged_packs ) {
+        pack->flush();
+    }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
 }
 
-void mapbuffer::save_quad(
-    const cata_path &dirname, const cata_path &filename, const tripoint_abs_omt &om_addr,
-    std::list<tripoint_abs_sm> &submaps_to_delete, bool delete_after_save )
+void mapbuffer::save_quad( submap_region_pack &pack, const tripoint_abs_omt &om_addr,
+                           std::list<tripoint_abs_sm> &submaps_to_delete, bool delete_after_save )
 {
     std::vector<point> offsets;
     std::vector<tripoint_abs_sm> submap_addrs;
@@ -205,7 +538,6 @@ void mapbuffer::save_quad(
 
     bool all_uniform = true;
     bool reverted_to_uniform = false;
-    bool const file_exists = fs::exists( filename.get_unrelative_path() );
     for( point &offsets_offset : offsets ) {
         tripoint_abs_sm submap_addr = project_to<coords::sm>( om_addr );
         submap_addr += offsets_offset;
@@ -215,7 +547,7 @@ void mapbuffer::save_quad(
             if( !sm->is_uniform() ) {
                 all_uniform = false;
             } else if( sm->reverted ) {
-                reverted_to_uniform = file_exists;
+                reverted_to_uniform = pack.contains( om_addr ) || pack.has_legacy_file( om_addr );
             }
         }
     }
@@ -230,55 +562,49 @@ void mapbuffer::save_quad(
             }
         }
 
-        // deleting the file might fail on some platforms in some edge cases so force serialize this
-        // uniform quad
-        if( !reverted_to_uniform ) {
-            return;
+        // A stored copy would be loaded instead of regenerating the quad, so drop it
+        if( reverted_to_uniform ) {
+            pack.stage_removal( om_addr );
         }
+        return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
+    std::ostringstream fout;
+    JsonOut jsout( fout );
+    jsout.start_array();
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            submap *sm = submaps[submap_addr].get();
+        submap *sm = submaps[submap_addr].get();
 
-            if( sm == nullptr ) {
-                continue;
-            }
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.start_object();
+        jsout.start_object();
 
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+        jsout.member( "version", savegame_version );
+        jsout.member( "coordinates" );
 
-            jsout.start_array();
-            jsout.write( submap_addr.x() );
-            jsout.write( submap_addr.y() );
-            jsout.write( submap_addr.z() );
-            jsout.end_array();
+        jsout.start_array();
+        jsout.write( submap_addr.x() );
+        jsout.write( submap_addr.y() );
+        jsout.write( submap_addr.z() );
+        jsout.end_array();
 
-            sm->store( jsout );
+        sm->store( jsout );
 
-            jsout.end_object();
+        jsout.end_object();
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
         }
-
-        jsout.end_array();
-    } );
-
-    if( all_uniform && reverted_to_uniform ) {
-        fs::remove( filename.get_unrelative_path() );
     }
+
+    jsout.end_array();
+    pack.stage( om_addr, fout.str() );
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
@@ -287,34 +613,42 @@ submap *mapbuffer::unserialize_submaps( const tripoint_abs_sm &p )
 {
     // Map the tripoint to the submap quad that stores it.
     const tripoint_abs_omt om_addr = project_to<coords::omt>( p );
-    const cata_path dirname = find_dirname( om_addr );
+    submap_region_pack &pack = region_pack( om_addr );
+    const cata_path &dirname = pack.directory();
     cata_path quad_path = find_quad_path( dirname, om_addr );
 
-    if( !file_exist( quad_path ) ) {
-        // Fix for old saves where the path was generated using std::stringstream, which
-        // did format the number using the current locale. That formatting may insert
-        // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
-        // of "map/1234.7.8.map".
-        std::ostringstream buffer;
-        buffer << om_addr.x() << "." << om_addr.y() << "." << om_addr.z()
-               << ".map";
-        cata_path legacy_quad_path = dirname / buffer.str();
-        if( file_exist( legacy_quad_path ) ) {
-            quad_path = std::move( legacy_quad_path );
+    if( std::optional<std::string> json = pack.read( om_addr ) ) {
+        deserialize( json_loader::from_string( *json ) );
+        quad_path = find_pack_path( dirname );
+    } else {
+        // Saves from before the segment packs have a file for every quad.
+        if( !file_exist( quad_path ) ) {
+            // Fix for old saves where the path was generated using std::stringstream, which
+            // did format the number using the current locale. That formatting may insert
+            // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
+            // of "map/1234.7.8.map".
+            std::ostringstream buffer;
+            buffer << om_addr.x() << "." << om_addr.y() << "." << om_addr.z()
+                   << ".map";
+            cata_path legacy_quad_path = dirname / buffer.str();
+            if( file_exist( legacy_quad_path ) ) {
+                quad_path = std::move( legacy_quad_path );
+            }
         }
-    }
 
-    if( !read_from_file_optional_json( quad_path, [this]( const JsonValue & jsin ) {
-    deserialize( jsin );
-    } ) ) {
-        // If it doesn't exist, trigger generating it.
-        return nullptr;
+        if( !read_from_file_optional_json( quad_path, [this]( const JsonValue & jsin ) {
+        deserialize( jsin );
+        } ) ) {
+            // If it doesn't exist, trigger generating it.
+            return nullptr;
+        }
+        pack.add_legacy_file( om_addr, quad_path );
     }
     // fill in uniform submaps that were not serialized
     oter_id const oid = overmap_buffer.ter( om_addr );
     generate_uniform_omt( project_to<coords::sm>( om_addr ), oid );
     if( submaps.count( p ) == 0 ) {
-        debugmsg( "file %s did not contain the expected submap %s for non-uniform terrain %s",
+        debugmsg( "%s did not contain the expected submap %s for non-uniform terrain %s",
                   quad_path.generic_u8string(), p.to_string(), oid.id().str() );
         return nullptr;
     }
@@ -13,6 +13,7 @@
 class cata_path;
 class JsonArray;
 class submap;
+class submap_region_pack;
 
 /**
  * Store, buffer, save and load the entire world map.
@@ -83,11 +84,13 @@ class mapbuffer
         void remove_submap( const tripoint_abs_sm &addr );
         submap *unserialize_submaps( const tripoint_abs_sm &p );
         void deserialize( const JsonArray &ja );
-        void save_quad(
-            const cata_path &dirname, const cata_path &filename,
-            const tripoint_abs_omt &om_addr, std::list<tripoint_abs_sm> &submaps_to_delete,
-            bool delete_after_save );
+        void save_quad( submap_region_pack &pack, const tripoint_abs_omt &om_addr,
+                        std::list<tripoint_abs_sm> &submaps_to_delete, bool delete_after_save );
+        /** The pack of the segment directory that om_addr is stored in. */
+        submap_region_pack &region_pack( const tripoint_abs_omt &om_addr );
         submap_map_t submaps; // NOLINT(cata-serialize)
+        // Indexes of the segment files looked at so far.
+        std::map<tripoint_abs_seg, std::unique_ptr<submap_region_pack>> region_packs; // NOLINT(cata-serialize)
 };
 
 extern mapbuffer MAPBUFFER;
@@ -12,6 +12,8 @@
 #include <ostream>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "behavior.h"
 #include "bionics.h"
@@ -58,6 +60,7 @@
 static const damage_type_id damage_cut( "cut" );
 
 static const efftype_id effect_bouldering( "bouldering" );
+static const efftype_id effect_controlled( "controlled" );
 static const efftype_id effect_countdown( "countdown" );
 static const efftype_id effect_cramped_space( "cramped_space" );
 static const efftype_id effect_docile( "docile" );
@@ -461,6 +464,19 @@ bool monster::mating_angry() const
     return mating_angry;
 }
 
+// Throttle monster thinking, if there are no apparent threats, stop paying attention.
+static constexpr int max_turns_for_rate_limiting = 1800;
+
+static bool looks_for_monster_targets( const int turns_since_target )
+{
+    constexpr double max_turns_to_skip = 600.0;
+    // Outputs a range from 0.0 - 1.0.
+    float rate_limiting_factor = 1.0 - logarithmic_range( 0, max_turns_for_rate_limiting,
+                                 turns_since_target );
+    int turns_to_skip = max_turns_to_skip * rate_limiting_factor;
+    return turns_to_skip == 0 || turns_since_target % turns_to_skip == 0;
+}
+
 void monster::plan()
 {
     monster_plan mon_plan( *this );
@@ -494,13 +510,32 @@ void monster::plan()
         }
         anger_cub_threatened( mon_plan );
     } else if( friendly != 0 && !mon_plan.docile ) {
-        for( monster &tmp : g->all_monsters() ) {
+        // rate_target rejects whatever it can't see, and without smart planning also anything
+        // farther than the sight range, so only the monsters around need to be looked at.
+        const int search_radius = mon_plan.smart_planning ? MAX_VIEW_DISTANCE :
+                                  std::min( MAX_VIEW_DISTANCE, mon_plan.max_sight_range );
+        creature_tracker &creatures = get_creature_tracker();
+        // The monsters rated best so far, of which the one listed first by the tracker wins.
+        std::vector<monster *> best;
+        creatures.for_each_monster_near( get_location(), search_radius, fov_3d_z_range,
+        [&]( monster & tmp ) {
             if( tmp.friendly == 0 && tmp.attitude_to( *this ) == Attitude::HOSTILE &&
                 seen_levels.test( tmp.posz() + OVERMAP_DEPTH ) ) {
                 float rating = rate_target( tmp, mon_plan.dist, mon_plan.smart_planning );
                 if( rating < mon_plan.dist ) {
                     mon_plan.target = &tmp;
                     mon_plan.dist = rating;
+                    best.assign( 1, &tmp );
+                } else if( rating == mon_plan.dist && !best.empty() ) {
+                    best.push_back( &tmp );
+                }
+            }
+        } );
+        if( best.size() > 1 ) {
+            for( const shared_ptr_fast<monster> &critter : creatures.get_monsters_list() ) {
+                if( std::find( best.begin(), best.end(), critter.get() ) != best.end() ) {
+                    mon_plan.target = critter.get();
+                    break;
                 }
             }
         }
@@ -565,15 +600,8 @@ void monster::plan()
     }
 
     mon_plan.fleeing = mon_plan.fleeing || ( mood == MATT_FLEE );
-    // Throttle monster thinking, if there are no apparent threats, stop paying attention.
-    constexpr int max_turns_for_rate_limiting = 1800;
-    constexpr double max_turns_to_skip = 600.0;
-    // Outputs a range from 0.0 - 1.0.
-    float rate_limiting_factor = 1.0 - logarithmic_range( 0, max_turns_for_rate_limiting,
-                                 turns_since_target );
-    int turns_to_skip = max_turns_to_skip * rate_limiting_factor;
     creature_tracker &tracker = get_creature_tracker();
-    if( friendly == 0 && ( turns_to_skip == 0 || turns_since_target % turns_to_skip == 0 ) ) {
+    if( friendly == 0 && looks_for_monster_targets( turns_since_target ) ) {
         tracker.for_each_reachable( *this, [this]( const mfaction_id & other ) {
             const mf_attitude faction_att = faction->attitude( other );
             return !( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY );
@@ -761,6 +789,64 @@ void monster::plan()
     }
 }
 
+void monster::add_plan_sight_lines( std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> &lines )
+const
+{
+    if( is_dead() || has_effect( effect_controlled ) ||
+        ( friendly != 0 && has_effect( effect_docile ) ) ) {
+        return;
+    }
+    map &here = get_map();
+    // Only the creatures plan() rates as targets, and only those within the range sees() would
+    // trace a line for.  Sight lines between levels aren't cached ahead, and adjacent creatures
+    // are seen without one.
+    const int range_max = std::max( sight_range( default_daylight_level() ), sight_range( 0 ) );
+    const int search_radius = has_flag( mon_flag_PRIORITIZE_TARGETS ) ? MAX_VIEW_DISTANCE :
+                              std::min( MAX_VIEW_DISTANCE, std::max( type->vision_day, type->vision_night ) );
+    const tripoint_bub_ms pos = pos_bub();
+    const auto add_line = [&]( const Creature & other ) {
+        const tripoint_bub_ms other_pos = other.pos_bub();
+        const int dist = rl_dist( pos, other_pos );
+        if( other_pos.z() != pos.z() || dist <= 1 || dist > search_radius || dist > range_max ) {
+            return;
+        }
+        const float light = here.ambient_light_at( other_pos );
+        if( dist <= sight_range( light ) ||
+            light > here.get_cache_ref( pos.z() ).natural_light_level_cache ) {
+            lines.emplace_back( pos, other_pos );
+        }
+    };
+    const auto hostile_faction = [this]( const mfaction_id & other ) {
+        const mf_attitude faction_att = faction->attitude( other );
+        return faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY;
+    };
+
+    if( friendly == 0 ) {
+        add_line( get_player_character() );
+        if( looks_for_monster_targets( turns_since_target ) ) {
+            get_creature_tracker().for_each_monster_near( get_location(), search_radius, 0,
+            [&]( monster & other ) {
+                if( &other != this && hostile_faction( other.faction ) ) {
+                    add_line( other );
+                }
+            } );
+        }
+    } else {
+        get_creature_tracker().for_each_monster_near( get_location(), search_radius, 0,
+        [&]( monster & other ) {
+            if( &other != this && other.friendly == 0 &&
+                other.attitude_to( *this ) == Attitude::HOSTILE ) {
+                add_line( other );
+            }
+        } );
+    }
+    for( const npc &who : g->all_npcs() ) {
+        if( hostile_faction( who.get_monster_faction() ) ) {
+            add_line( who );
+        }
+    }
+}
+
 /**
  * Method to make monster movement speed consistent in the face of staggering behavior and
  * differing distance metrics.
@@ -1030,7 +1116,8 @@ void monster::move()
                 ( path.empty() || rl_dist( pos_bub(), path.front() ) >= 2 || path.back() != local_dest ) ) {
                 // We need a new path
                 if( can_pathfind() ) {
-                    path = here.route( pos_bub(), local_dest, pf_settings, get_path_avoid() );
+                    path = here.route( pos_bub(), local_dest, pf_settings, monster_path_avoid( *this ),
+                                       get_path_avoid_key() );
                     if( path.empty() ) {
                         increment_pathfinding_cd();
                     }
@@ -1424,10 +1511,6 @@ void monster::footsteps( const tripoint_bub_ms &p )
 
 tripoint_bub_ms monster::scent_move()
 {
-    // TODO: Remove when scentmap is 3D
-    if( std::abs( posz() - get_map().get_abs_sub().z() ) > SCENT_MAP_Z_REACH ) {
-        return { -1, -1, INT_MIN };
-    }
     scent_map &scents = get_scent();
     bool in_range = scents.inbounds( pos() );
     if( !in_range ) {
@@ -31,6 +31,7 @@
 #include "game.h"
 #include "game_constants.h"
 #include "harvest.h"
+#include "hash_utils.h"
 #include "item.h"
 #include "item_group.h"
 #include "itype.h"
@@ -4075,27 +4076,45 @@ const pathfinding_settings &monster::get_pathfinding_settings() const
     return type->path_settings;
 }
 
+std::optional<size_t> monster::get_path_avoid_key() const
+{
+    // Avoiding creatures depends on where they are, and aquatic monsters on whether they
+    // are under a vehicle themselves.  Effects can change what we may pass in many ways.
+    if( has_flag( mon_flag_PRIORITIZE_TARGETS ) || has_flag( mon_flag_PATH_AVOID_DANGER ) ||
+        has_flag( mon_flag_AQUATIC ) || !effects->empty() ) {
+        return std::nullopt;
+    }
+    // The remaining state can_move_to() looks at, see will_move_to() and know_danger_at().
+    const Character &player = get_player_character();
+    size_t key = std::hash<mtype_id>()( type->id );
+    cata::hash_combine( key, digging() );
+    cata::hash_combine( key, player.get_location() == get_dest() &&
+                        attitude( &player ) == MATT_ATTACK );
+    cata::hash_combine( key, get_armor_type( damage_cut, bodypart_id( "torso" ) ) >= 10 );
+    return key;
+}
+
 std::function<bool( const tripoint_bub_ms & )> monster::get_path_avoid() const
 {
-    return [this]( const tripoint_bub_ms & p ) {
-        map &here = get_map();
-        // If we can't move there and can't bash it, don't path through it.
-        if( !can_move_to( p ) && ( bash_skill() <= 0 || !here.is_bashable( p ) ) ) {
-            return true;
-        }
+    return monster_path_avoid( *this );
+}
 
-        // Avoid nearby creatures if we have the flag.
-        int radius;
-        if( has_flag( mon_flag_PRIORITIZE_TARGETS ) ) {
-            radius = 2;
-        } else if( has_flag( mon_flag_PATH_AVOID_DANGER ) ) {
-            radius = 1;
-        } else {
-            return false;
-        }
-        if( rl_dist( p, pos_bub() ) <= radius && get_creature_tracker().creature_at( p ) ) {
-            return true;
-        }
-        return false;
-    };
+monster_path_avoid::monster_path_avoid( const monster &critter ) : mon( &critter )
+{
+    // Avoid nearby creatures if we have the flag.
+    if( critter.has_flag( mon_flag_PRIORITIZE_TARGETS ) ) {
+        creature_radius = 2;
+    } else if( critter.has_flag( mon_flag_PATH_AVOID_DANGER ) ) {
+        creature_radius = 1;
+    }
+}
+
+bool monster_path_avoid::operator()( const tripoint_bub_ms &p ) const
+{
+    // If we can't move there and can't bash it, don't path through it.
+    if( !mon->can_move_to( p ) && ( mon->bash_skill() <= 0 || !get_map().is_bashable( p ) ) ) {
+        return true;
+    }
+    return creature_radius > 0 && rl_dist( p, mon->pos_bub() ) <= creature_radius &&
+           get_creature_tracker().creature_at( p ) != nullptr;
 }
@@ -252,6 +252,12 @@ class monster : public Creature
         // is it mating season?
         bool mating_angry() const;
         void plan();
+        /**
+         * Adds the lines of sight (from, to) to other creatures that plan() may check this
+         * turn, so they can be worked out ahead of time, see map::cache_sight_lines.
+         */
+        void add_plan_sight_lines( std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> &lines )
+        const;
         void anger_hostile_seen( const monster_plan &mon_plan );
         void anger_mating_season( const monster_plan &mon_plan );
         // will change mon_plan::dist
@@ -623,6 +629,12 @@ class monster : public Creature
 
         const pathfinding_settings &get_pathfinding_settings() const override;
         std::function<bool( const tripoint_bub_ms & )> get_path_avoid() const override;
+        /**
+         * Summarises everything about this monster that get_path_avoid() depends on, besides the
+         * map itself, so that monsters with equal keys can share routes (see map::route).
+         * Empty if the predicate depends on things such as nearby creatures or active effects.
+         */
+        std::optional<size_t> get_path_avoid_key() const;
     private:
         void process_trigger( mon_trigger trig, int amount );
         void process_trigger( mon_trigger trig, const std::function<int()> &amount_func );
@@ -681,4 +693,20 @@ class monster : public Creature
         void process_one_effect( effect &it, bool is_new ) override;
 };
 
+/**
+ * The points a monster does not path through, see monster::get_path_avoid().  Passed to
+ * map::route as is, the search calls it directly instead of through std::function.
+ */
+class monster_path_avoid
+{
+    public:
+        explicit monster_path_avoid( const monster &critter );
+        bool operator()( const tripoint_bub_ms &p ) const;
+
+    private:
+        const monster *mon;
+        // Other creatures this close to the monster are avoided, or none if 0.
+        int creature_radius = 0;
+};
+
 #endif // CATA_SRC_MONSTER_H
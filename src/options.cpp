@@ -2973,6 +2973,21 @@ void options_manager::add_options_debug()
          false
 #endif
        );
+
+    add( "WORKER_THREADS", "debug", to_translation( "Worker threads" ),
+         to_translation( "Number of threads used for work that can run in parallel, such as verifying data during loading.  0 uses one thread per available core, 1 disables parallel work." ),
+         0, 64, 0
+       );
+
+    add( "DATA_SNAPSHOTS", "debug", to_translation( "Snapshot game data" ),
+         to_translation( "If enabled, the parsed JSON data of each mod is stored as a single snapshot file in the user directory and reused while the mod's files are unchanged.  Speeds up loading at the cost of disk space." ),
+         false
+       );
+
+    add( "GAS_SPREAD_GRID", "debug", to_translation( "Spread gas over the whole map at once" ),
+         to_translation( "If enabled, gas moves between all tiles of the map at the same time, based on where it was at the start of the turn, instead of one tile after another.  Faster for large clouds.  Experimental." ),
+         false
+       );
 }
 
 void options_manager::add_options_android()
@@ -4098,6 +4113,9 @@ void options_manager::update_options_cache()
     message_ttl = ::get_option<int>( "MESSAGE_TTL" );
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    worker_threads = ::get_option<int>( "WORKER_THREADS" );
+    data_snapshots = ::get_option<bool>( "DATA_SNAPSHOTS" );
+    gas_spread_grid = ::get_option<bool>( "GAS_SPREAD_GRID" );
     keycode_mode = ::get_option<std::string>( "SDL_KEYBOARD_MODE" ) == "keycode";
     use_pinyin_search = ::get_option<bool>( "USE_PINYIN_SEARCH" );
 
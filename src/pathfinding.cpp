@@ -3,22 +3,28 @@
 #include <algorithm>
 #include <array>
 #include <cstdlib>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <queue>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
 #include "game.h"
+#include "game_constants.h"
 #include "gates.h"
 #include "line.h"
 #include "map.h"
 #include "mapdata.h"
+#include "monster.h"
 #include "point.h"
 #include "submap.h"
 #include "trap.h"
@@ -393,6 +399,34 @@ int map::extra_cost( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
 std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
         const pathfinding_settings &settings,
         const std::function<bool( const tripoint_bub_ms & )> &avoid ) const
+{
+    return find_route( f, t, settings, avoid, std::nullopt );
+}
+
+std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+        const pathfinding_settings &settings,
+        const std::function<bool( const tripoint_bub_ms & )> &avoid, size_t avoid_key ) const
+{
+    return find_route( f, t, settings, avoid, avoid_key );
+}
+
+std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+        const pathfinding_settings &settings, const path_avoid_mask &avoid ) const
+{
+    return find_route( f, t, settings, avoid, std::nullopt );
+}
+
+std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+        const pathfinding_settings &settings, const monster_path_avoid &avoid,
+        const std::optional<size_t> avoid_key ) const
+{
+    return find_route( f, t, settings, avoid, avoid_key );
+}
+
+template<typename Avoid>
+std::vector<tripoint_bub_ms> map::find_route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+        const pathfinding_settings &settings, const Avoid &avoid,
+        const std::optional<size_t> avoid_key, const bool use_portals ) const
 {
     /* TODO: If the origin or destination is out of bound, figure out the closest
      * in-bounds point and go to that, then to the real origin/destination.
@@ -406,14 +440,14 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
     if( !inbounds( t ) ) {
         tripoint_bub_ms clipped = t;
         clip_to_bounds( clipped );
-        return route( f, clipped, settings, avoid );
+        return find_route( f, clipped, settings, avoid, avoid_key, use_portals );
     }
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
     if( f.z() == t.z() ) {
         auto line_path = straight_route( f, t );
         if( !line_path.empty() ) {
-            if( std::none_of( line_path.begin(), line_path.end(), avoid ) ) {
+            if( std::none_of( line_path.begin(), line_path.end(), std::cref( avoid ) ) ) {
                 return line_path;
             }
         }
@@ -424,6 +458,28 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
         return ret;
     }
 
+    const bool shared = avoid_key && f.z() == t.z();
+    if( shared ) {
+        // Brings the pathfinding cache up to date, which drops the routes its changes affect.
+        get_pathfinding_cache_ref( f.z() );
+        std::optional<std::vector<tripoint_bub_ms>> cached = routes->find( f, t, settings,
+                *avoid_key );
+        if( cached ) {
+            return *cached;
+        }
+        // Once several callers converge on t, one search backwards from t serves all of them.
+        const flow_field *field = routes->find_field( t, settings, *avoid_key );
+        if( field == nullptr && routes->wants_field( t, settings, *avoid_key ) ) {
+            field = &routes->add_field( build_flow_field( t, settings, avoid, *avoid_key ) );
+        }
+        if( field != nullptr && field->contains( f ) ) {
+            std::vector<tripoint_bub_ms> from_field = field->route_from( f );
+            if( !from_field.empty() ) {
+                return from_field;
+            }
+        }
+    }
+
     const int max_length = settings.max_length;
 
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
@@ -439,6 +495,8 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
     pf.add_point( 0, 0, f.raw(), f.raw() );
 
     bool done = false;
+    // Whether the search was held back by the edges of the box rather than the map's.
+    bool reached_box_edge = false;
 
     do {
         tripoint_bub_ms cur( pf.get_next() );
@@ -475,6 +533,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
 
             // TODO: Remove this and instead have sentinels at the edges
             if( p.x() < min.x() || p.x() >= max.x() || p.y() < min.y() || p.y() >= max.y() ) {
+                reached_box_edge = reached_box_edge || inbounds( p );
                 continue;
             }
 
@@ -644,7 +703,557 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
         }
 
         std::reverse( ret.begin(), ret.end() );
+
+        if( shared && std::all_of( ret.begin(), ret.end(), [&f]( const tripoint_bub_ms & p ) {
+        return p.z() == f.z();
+        } ) ) {
+            routes->add( f, ret, settings, *avoid_key, min, max );
+        }
+    } else if( use_portals && reached_box_edge && f.z() == t.z() ) {
+        // The box around f and t may just be too small to get around whatever is in the way.
+        // A failed plan is remembered for the turn, it is as expensive as the search itself.
+        if( !avoid_key || !routes->portal_route_failed( f, t, settings, *avoid_key ) ) {
+            ret = route_via_portals( f, t, settings, avoid );
+            if( ret.empty() && avoid_key ) {
+                routes->add_failed_portal_route( f, t, settings, *avoid_key );
+            }
+        }
+    }
+
+    return ret;
+}
+
+template<typename Avoid>
+std::vector<tripoint_bub_ms> map::route_via_portals( const tripoint_bub_ms &f,
+        const tripoint_bub_ms &t, const pathfinding_settings &settings, const Avoid &avoid ) const
+{
+    const int z = f.z();
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( z );
+    // Walking cost only, doors count for those who can open them.  Who can bash or climb
+    // what is left to the searches along the plan.
+    const bool through_doors = settings.allow_open_doors;
+    const portal_graph::cost_function cost_fn = [this, &pf_cache, z,
+    through_doors]( const point_bub_ms & p ) {
+        const PathfindingFlags p_special = pf_cache.special[p.x()][p.y()];
+        if( !( p_special & PathfindingFlag::Obstacle ) ) {
+            return p_special & PathfindingFlag::Slow ? 4 : 2;
+        }
+        if( !through_doors ) {
+            return -1;
+        }
+        const const_maptile &tile = maptile_at_internal( tripoint_bub_ms( p, z ) );
+        if( tile.get_ter_t().open || tile.get_furn_t().open ) {
+            return 4;
+        }
+        return -1;
+    };
+
+    pathfinding_cache &graphs = get_pathfinding_cache( z );
+    portal_graph &graph = through_doors ? graphs.portals : graphs.portals_without_doors;
+    int cost = 0;
+    const std::vector<point_bub_ms> waypoints = graph.plan( f.xy(), t.xy(), getmapsize(), cost_fn,
+            cost );
+    if( waypoints.empty() || cost > settings.max_length ) {
+        return {};
+    }
+
+    std::vector<tripoint_bub_ms> ret;
+    tripoint_bub_ms from = f;
+    for( const point_bub_ms &wp : waypoints ) {
+        const tripoint_bub_ms to( wp, z );
+        if( to != t && avoid( to ) ) {
+            return {};
+        }
+        const std::vector<tripoint_bub_ms> leg = find_route( from, to, settings, avoid, std::nullopt,
+                false );
+        if( leg.empty() ) {
+            return {};
+        }
+        ret.insert( ret.end(), leg.begin(), leg.end() );
+        from = to;
+    }
+    return ret;
+}
+
+template<typename Avoid>
+flow_field map::build_flow_field( const tripoint_bub_ms &t,
+                                  const pathfinding_settings &settings,
+                                  const Avoid &avoid, const size_t avoid_key ) const
+{
+    flow_field field;
+    field.target = t;
+    field.settings = settings;
+    field.avoid_key = avoid_key;
+    // Everyone who may use the field is within max_dist of t, pad as map::route does.
+    const int reach = settings.max_dist + 16;
+    field.min = t + tripoint_rel_ms( -reach, -reach, 0 );
+    field.max = t + tripoint_rel_ms( reach, reach, 0 );
+    clip_to_bounds( field.min );
+    clip_to_bounds( field.max );
+    const size_t area = static_cast<size_t>( field.max.x() - field.min.x() + 1 ) *
+                        ( field.max.y() - field.min.y() + 1 );
+    field.cost.assign( area, -1 );
+    field.next.assign( area, -1 );
+
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z() );
+    std::vector<bool> closed( area, false );
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, pair_greater_cmp_first>
+    open;
+    const int target_index = field.index( t );
+    field.cost[target_index] = 0;
+    open.emplace( 0, target_index );
+
+    // The same moves and costs as map::route, only searched from the other end: each point
+    // popped here already has its cheapest route, and we look for the points that step into it.
+    constexpr std::array<int, 8> x_offset{ { -1,  1,  0,  0,  1, -1, -1, 1 } };
+    constexpr std::array<int, 8> y_offset{ {  0,  0, -1,  1, -1,  1, -1, 1 } };
+    while( !open.empty() ) {
+        const int cur_cost = open.top().first;
+        const int cur_index = open.top().second;
+        open.pop();
+        if( closed[cur_index] ) {
+            continue;
+        }
+        closed[cur_index] = true;
+        const tripoint_bub_ms cur = field.point_at( cur_index );
+        const PathfindingFlags cur_special = pf_cache.special[cur.x()][cur.y()];
+
+        // map::route climbs down ledges instead of stepping onto them, which leaves this level.
+        if( settings.avoid_traps && ( cur_special & PathfindingFlag::DangerousTrap ) ) {
+            const const_maptile &tile = maptile_at_internal( cur );
+            const ter_t &terrain = tile.get_ter_t();
+            const trap &ter_trp = terrain.trap.obj();
+            const trap &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+            if( !trp.is_benign() && terrain.has_flag( ter_furn_flag::TFLAG_NO_FLOOR ) &&
+                valid_move( cur, cur + tripoint::below, false, true ) ) {
+                continue;
+            }
+        }
+
+        for( size_t i = 0; i < 8; i++ ) {
+            const tripoint_bub_ms p( cur.x() + x_offset[i], cur.y() + y_offset[i], cur.z() );
+            if( !field.contains( p ) ) {
+                continue;
+            }
+            const int index = field.index( p );
+            if( closed[index] ) {
+                continue;
+            }
+            if( avoid( p ) ) {
+                closed[index] = true;
+                continue;
+            }
+            // Cost of stepping from p into cur, diagonals penalized as in map::route.
+            const int cost = extra_cost( p, cur, settings, cur_special );
+            if( cost < 0 ) {
+                continue;
+            }
+            const int new_cost = cur_cost + cost + ( ( cur.x() != p.x() && cur.y() != p.y() ) ? 1 : 0 );
+            if( new_cost > settings.max_length ) {
+                continue;
+            }
+            if( field.cost[index] < 0 || new_cost < field.cost[index] ) {
+                field.cost[index] = new_cost;
+                field.next[index] = cur_index;
+                open.emplace( new_cost, index );
+            }
+        }
+    }
+    return field;
+}
+
+void path_avoid_mask::set( const tripoint_bub_ms &p )
+{
+    if( p.x() < 0 || p.x() >= MAPSIZE_X || p.y() < 0 || p.y() >= MAPSIZE_Y ||
+        p.z() < -OVERMAP_DEPTH || p.z() > OVERMAP_HEIGHT ) {
+        return;
+    }
+    std::unique_ptr<layer> &l = layers[p.z() + OVERMAP_DEPTH];
+    if( !l ) {
+        l = std::make_unique<layer>();
+    }
+    l->set( p.x() * MAPSIZE_Y + p.y() );
+}
+
+bool pathfinding_settings::operator==( const pathfinding_settings &rhs ) const
+{
+    return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+           max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+           allow_open_doors == rhs.allow_open_doors && allow_unlock_doors == rhs.allow_unlock_doors &&
+           avoid_traps == rhs.avoid_traps && allow_climb_stairs == rhs.allow_climb_stairs &&
+           avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp &&
+           avoid_dangerous_fields == rhs.avoid_dangerous_fields && size == rhs.size;
+}
+
+// Enough for a crowd of creatures all chasing different targets.
+static constexpr size_t max_cached_routes = 64;
+
+// Building a flow field costs about as much as a few ordinary searches, so keep the few that
+// are shared by the most callers: there is seldom more than a handful of popular targets.
+static constexpr size_t max_cached_fields = 8;
+
+void route_cache::expire_old_turns()
+{
+    if( turn != calendar::turn ) {
+        entries.clear();
+        field_requests.clear();
+        fields.clear();
+        failed_portal_routes.clear();
+        turn = calendar::turn;
+    }
+}
+
+std::optional<std::vector<tripoint_bub_ms>> route_cache::find( const tripoint_bub_ms &f,
+        const tripoint_bub_ms &t, const pathfinding_settings &settings, const size_t avoid_key )
+{
+    expire_old_turns();
+    for( const entry &e : entries ) {
+        if( e.points.back() != t || e.avoid_key != avoid_key || !( e.settings == settings ) ) {
+            continue;
+        }
+        // Every part of a shortest route is itself a shortest route.
+        const auto here = std::find( e.points.begin(), e.points.end(), f );
+        if( here != e.points.end() ) {
+            return std::vector<tripoint_bub_ms>( std::next( here ), e.points.end() );
+        }
+    }
+    return std::nullopt;
+}
+
+void route_cache::add( const tripoint_bub_ms &f, const std::vector<tripoint_bub_ms> &route,
+                       const pathfinding_settings &settings, const size_t avoid_key,
+                       const tripoint_bub_ms &min, const tripoint_bub_ms &max )
+{
+    expire_old_turns();
+    if( entries.size() >= max_cached_routes ) {
+        entries.erase( entries.begin() );
+    }
+    entry e{ { f }, settings, avoid_key, min, max };
+    e.points.insert( e.points.end(), route.begin(), route.end() );
+    entries.emplace_back( std::move( e ) );
+}
+
+const flow_field *route_cache::find_field( const tripoint_bub_ms &t,
+        const pathfinding_settings &settings, const size_t avoid_key )
+{
+    expire_old_turns();
+    for( const flow_field &field : fields ) {
+        if( field.target == t && field.avoid_key == avoid_key && field.settings == settings ) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+bool route_cache::wants_field( const tripoint_bub_ms &t, const pathfinding_settings &settings,
+                               const size_t avoid_key )
+{
+    expire_old_turns();
+    for( const field_request &request : field_requests ) {
+        if( request.target == t && request.avoid_key == avoid_key && request.settings == settings ) {
+            return true;
+        }
     }
+    field_requests.push_back( field_request{ t, settings, avoid_key } );
+    return false;
+}
+
+const flow_field &route_cache::add_field( flow_field &&field )
+{
+    expire_old_turns();
+    if( fields.size() >= max_cached_fields ) {
+        fields.erase( fields.begin() );
+    }
+    fields.emplace_back( std::move( field ) );
+    return fields.back();
+}
+
+bool route_cache::portal_route_failed( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                       const pathfinding_settings &settings, const size_t avoid_key )
+{
+    expire_old_turns();
+    return std::any_of( failed_portal_routes.begin(), failed_portal_routes.end(),
+    [&]( const failed_route & e ) {
+        return e.from == f && e.to == t && e.avoid_key == avoid_key && e.settings == settings;
+    } );
+}
 
+void route_cache::add_failed_portal_route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+        const pathfinding_settings &settings, const size_t avoid_key )
+{
+    expire_old_turns();
+    if( failed_portal_routes.size() >= max_cached_routes ) {
+        failed_portal_routes.erase( failed_portal_routes.begin() );
+    }
+    failed_portal_routes.push_back( failed_route{ f, t, settings, avoid_key } );
+}
+
+template<typename T>
+static bool within_bounds( const T &area, const int zlev, const point_bub_ms &p )
+{
+    return area.min.z() <= zlev && zlev <= area.max.z() &&
+           area.min.x() <= p.x() && p.x() <= area.max.x() &&
+           area.min.y() <= p.y() && p.y() <= area.max.y();
+}
+
+void route_cache::invalidate( const int zlev )
+{
+    const auto on_level = [zlev]( const auto & area ) {
+        return area.min.z() <= zlev && zlev <= area.max.z();
+    };
+    entries.erase( std::remove_if( entries.begin(), entries.end(), on_level ), entries.end() );
+    fields.erase( std::remove_if( fields.begin(), fields.end(), on_level ), fields.end() );
+    drop_failed_portal_routes( zlev );
+}
+
+void route_cache::invalidate( const int zlev, const std::unordered_set<point_bub_ms> &points )
+{
+    if( points.empty() ) {
+        return;
+    }
+    const auto affected = [&]( const auto & area ) {
+        return std::any_of( points.begin(), points.end(), [&]( const point_bub_ms & p ) {
+            return within_bounds( area, zlev, p );
+        } );
+    };
+    entries.erase( std::remove_if( entries.begin(), entries.end(), affected ), entries.end() );
+    fields.erase( std::remove_if( fields.begin(), fields.end(), affected ), fields.end() );
+    // A portal plan may have crossed the whole level.
+    drop_failed_portal_routes( zlev );
+}
+
+void route_cache::drop_failed_portal_routes( const int zlev )
+{
+    failed_portal_routes.erase( std::remove_if( failed_portal_routes.begin(),
+    failed_portal_routes.end(), [zlev]( const failed_route & e ) {
+        return e.from.z() == zlev;
+    } ), failed_portal_routes.end() );
+}
+
+bool flow_field::contains( const tripoint_bub_ms &p ) const
+{
+    return p.z() == target.z() && min.x() <= p.x() && p.x() <= max.x() &&
+           min.y() <= p.y() && p.y() <= max.y();
+}
+
+int flow_field::index( const tripoint_bub_ms &p ) const
+{
+    return ( p.y() - min.y() ) * ( max.x() - min.x() + 1 ) + p.x() - min.x();
+}
+
+tripoint_bub_ms flow_field::point_at( const int index ) const
+{
+    const int width = max.x() - min.x() + 1;
+    return tripoint_bub_ms( min.x() + index % width, min.y() + index / width, target.z() );
+}
+
+std::vector<tripoint_bub_ms> flow_field::route_from( const tripoint_bub_ms &f ) const
+{
+    std::vector<tripoint_bub_ms> ret;
+    int i = index( f );
+    if( cost[i] < 0 ) {
+        return ret;
+    }
+    const int target_index = index( target );
+    while( i != target_index ) {
+        i = next[i];
+        ret.push_back( point_at( i ) );
+    }
     return ret;
 }
+
+static point submap_of( const point_bub_ms &p )
+{
+    return point( p.x() / SEEX, p.y() / SEEY );
+}
+
+static int submap_index( const point_bub_ms &p )
+{
+    return ( p.x() % SEEX ) * SEEY + p.y() % SEEY;
+}
+
+// Costs of walking from `from` to every tile of its submap without leaving it, -1 where that
+// isn't possible.  Indexed by submap_index().
+static std::array<int, SEEX * SEEY> submap_costs( const point_bub_ms &from,
+        const portal_graph::cost_function &cost_fn )
+{
+    std::array<int, SEEX * SEEY> costs;
+    costs.fill( -1 );
+    const point origin = submap_of( from ) * SEEX;
+    std::priority_queue<std::pair<int, point_bub_ms>, std::vector<std::pair<int, point_bub_ms>>,
+        pair_greater_cmp_first> open;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const int cost = open.top().first;
+        const point_bub_ms cur = open.top().second;
+        open.pop();
+        int &cur_cost = costs[submap_index( cur )];
+        if( cur_cost >= 0 ) {
+            continue;
+        }
+        cur_cost = cost;
+        for( const tripoint &d : eight_horizontal_neighbors ) {
+            const point_bub_ms p = cur + d.xy();
+            if( p.x() < origin.x || p.x() >= origin.x + SEEX || p.y() < origin.y ||
+                p.y() >= origin.y + SEEY || costs[submap_index( p )] >= 0 ) {
+                continue;
+            }
+            const int step = cost_fn( p );
+            if( step < 0 ) {
+                continue;
+            }
+            open.emplace( cost + step + ( d.x != 0 && d.y != 0 ? 1 : 0 ), p );
+        }
+    }
+    return costs;
+}
+
+portal_graph::submap_portals &portal_graph::get_submap( const point &sm,
+        const cost_function &cost_fn )
+{
+    submap_portals &portals = submaps[sm.x * mapsize + sm.y];
+    if( portals.valid ) {
+        return portals;
+    }
+    portals.nodes.clear();
+    portals.links.clear();
+
+    struct edge {
+        point dir;
+        point start;
+        point step;
+    };
+    // Both submaps sharing an edge walk it in the same direction, so they agree on the portals.
+    static constexpr std::array<edge, 4> edges{ {
+            { point::west, point::zero, point::south },
+            { point::east, point( SEEX - 1, 0 ), point::south },
+            { point::north, point::zero, point::east },
+            { point::south, point( 0, SEEY - 1 ), point::east },
+        }
+    };
+    const point origin = sm * SEEX;
+    for( const edge &e : edges ) {
+        const point neighbour = sm + e.dir;
+        if( neighbour.x < 0 || neighbour.x >= mapsize || neighbour.y < 0 ||
+            neighbour.y >= mapsize ) {
+            continue;
+        }
+        int run_start = -1;
+        for( int i = 0; i <= SEEX; i++ ) {
+            const point_bub_ms inside( origin + e.start + e.step * i );
+            const bool open = i < SEEX && cost_fn( inside ) >= 0 && cost_fn( inside + e.dir ) >= 0;
+            if( open && run_start < 0 ) {
+                run_start = i;
+            } else if( !open && run_start >= 0 ) {
+                const point_bub_ms node( origin + e.start + e.step * ( ( run_start + i - 1 ) / 2 ) );
+                portals.nodes.push_back( node );
+                portals.links.push_back( node + e.dir );
+                run_start = -1;
+            }
+        }
+    }
+
+    portals.costs.clear();
+    for( const point_bub_ms &node : portals.nodes ) {
+        const std::array<int, SEEX * SEEY> costs = submap_costs( node, cost_fn );
+        std::vector<int> &node_costs = portals.costs.emplace_back();
+        for( const point_bub_ms &other : portals.nodes ) {
+            node_costs.push_back( costs[submap_index( other )] );
+        }
+    }
+    portals.valid = true;
+    return portals;
+}
+
+std::vector<point_bub_ms> portal_graph::plan( const point_bub_ms &f, const point_bub_ms &t,
+        const int new_mapsize, const cost_function &cost_fn, int &cost )
+{
+    if( new_mapsize != mapsize ) {
+        mapsize = new_mapsize;
+        submaps.assign( static_cast<size_t>( mapsize ) * mapsize, submap_portals() );
+    }
+    const point t_sm = submap_of( t );
+    if( submap_of( f ) == t_sm ) {
+        return {};
+    }
+
+    std::unordered_map<point_bub_ms, int> gscore;
+    std::unordered_map<point_bub_ms, point_bub_ms> parent;
+    std::unordered_set<point_bub_ms> closed;
+    std::priority_queue<std::pair<int, point_bub_ms>, std::vector<std::pair<int, point_bub_ms>>,
+        pair_greater_cmp_first> open;
+    const auto add = [&]( const point_bub_ms & from, const point_bub_ms & p, const int g ) {
+        const auto it = gscore.find( p );
+        if( closed.count( p ) || ( it != gscore.end() && it->second <= g ) ) {
+            return;
+        }
+        gscore[p] = g;
+        parent[p] = from;
+        open.emplace( g + 2 * square_dist( p, t ), p );
+    };
+
+    const std::array<int, SEEX * SEEY> from_start = submap_costs( f, cost_fn );
+    for( const point_bub_ms &node : get_submap( submap_of( f ), cost_fn ).nodes ) {
+        const int start_cost = from_start[submap_index( node )];
+        if( start_cost >= 0 ) {
+            add( f, node, start_cost );
+        }
+    }
+    // Walking costs are close enough to symmetric to search the last stretch backwards.
+    const std::array<int, SEEX * SEEY> to_goal = submap_costs( t, cost_fn );
+
+    while( !open.empty() ) {
+        const point_bub_ms cur = open.top().second;
+        open.pop();
+        if( !closed.insert( cur ).second ) {
+            continue;
+        }
+        const int g = gscore[cur];
+        if( cur == t ) {
+            std::vector<point_bub_ms> ret;
+            for( point_bub_ms p = t; p != f; p = parent[p] ) {
+                ret.push_back( p );
+            }
+            std::reverse( ret.begin(), ret.end() );
+            cost = g;
+            return ret;
+        }
+
+        const point sm = submap_of( cur );
+        if( sm == t_sm && to_goal[submap_index( cur )] >= 0 ) {
+            add( cur, t, g + to_goal[submap_index( cur )] );
+        }
+        const submap_portals &portals = get_submap( sm, cost_fn );
+        for( size_t i = 0; i < portals.nodes.size(); i++ ) {
+            if( portals.nodes[i] != cur ) {
+                continue;
+            }
+            add( cur, portals.links[i], g + cost_fn( portals.links[i] ) );
+            for( size_t j = 0; j < portals.nodes.size(); j++ ) {
+                if( portals.costs[i][j] > 0 ) {
+                    add( cur, portals.nodes[j], g + portals.costs[i][j] );
+                }
+            }
+        }
+    }
+    return {};
+}
+
+void portal_graph::invalidate()
+{
+    for( submap_portals &portals : submaps ) {
+        portals.valid = false;
+    }
+}
+
+void portal_graph::invalidate( const point_bub_ms &p )
+{
+    // Portals on the edges of the submap depend on the tiles across them.
+    const point sm = submap_of( p );
+    for( const point &d : five_cardinal_directions ) {
+        const point affected = sm + d;
+        if( affected.x >= 0 && affected.x < mapsize && affected.y >= 0 && affected.y < mapsize ) {
+            submaps[affected.x * mapsize + affected.y].valid = false;
+        }
+    }
+}
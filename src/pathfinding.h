@@ -2,8 +2,17 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <unordered_set>
+#include <vector>
 
+#include "calendar.h"
+#include "coordinates.h"
 #include "coords_fwd.h"
 #include "game_constants.h"
 #include "mdarray.h"
@@ -122,6 +131,44 @@ constexpr PathfindingFlags operator |( const PathfindingFlag &a, const Pathfindi
     return PathfindingFlags( a ) | PathfindingFlags( b );
 }
 
+// Coarse graph over the submaps of one z-level, for planning routes that leave the area
+// map::route searches directly, in the manner of HPA*.  Neighbouring submaps are linked by a
+// portal for every stretch of walkable tiles along their shared edge, and the portals of a
+// submap by the cost of walking between them without leaving it.
+// Submaps are only analysed once a plan needs them, and again after one of their tiles changed.
+class portal_graph
+{
+    public:
+        // Rough cost of walking onto a tile, or a negative value if it can't be walked onto.
+        // Must not depend on who is walking, as the graph is shared by everyone using it.
+        using cost_function = std::function<int( const point_bub_ms & )>;
+
+        // The portal tiles a route from f to t passes through, followed by t itself.
+        // Empty if there is no such route, or if f and t are in the same submap.
+        // cost is set to the estimated cost of the whole route.
+        std::vector<point_bub_ms> plan( const point_bub_ms &f, const point_bub_ms &t, int mapsize,
+                                        const cost_function &cost_fn, int &cost );
+
+        void invalidate();
+        // The submap containing p, and those sharing an edge with it, need to be analysed again.
+        void invalidate( const point_bub_ms &p );
+
+    private:
+        struct submap_portals {
+            bool valid = false;
+            // Portal tiles inside the submap.
+            std::vector<point_bub_ms> nodes;
+            // For each portal, the tile in the neighbouring submap it leads to.
+            std::vector<point_bub_ms> links;
+            // costs[i][j] is the cost of walking from nodes[i] to nodes[j], or -1.
+            std::vector<std::vector<int>> costs;
+        };
+        submap_portals &get_submap( const point &sm, const cost_function &cost_fn );
+
+        int mapsize = 0;
+        std::vector<submap_portals> submaps;
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
 
@@ -129,6 +176,10 @@ struct pathfinding_cache {
     std::unordered_set<point_bub_ms> dirty_points;
 
     cata::mdarray<PathfindingFlags, point_bub_ms> special;
+
+    // For those who can open doors, and for everyone else.
+    portal_graph portals;
+    portal_graph portals_without_doors;
 };
 
 struct pathfinding_settings {
@@ -161,6 +212,113 @@ struct pathfinding_settings {
           avoid_rough_terrain( art ), avoid_sharp( as ), size( sz )  {}
 
     pathfinding_settings &operator=( const pathfinding_settings & ) = default;
+
+    bool operator==( const pathfinding_settings &rhs ) const;
+};
+
+// Points a route must not pass through, for callers that can list them up front.  Looking
+// them up is a bit test, where a predicate passed to map::route is a call through
+// std::function for every point the search considers.
+class path_avoid_mask
+{
+    public:
+        // Points outside the reality bubble are ignored.
+        void set( const tripoint_bub_ms &p );
+
+        bool operator()( const tripoint_bub_ms &p ) const {
+            const std::unique_ptr<layer> &l = layers[p.z() + OVERMAP_DEPTH];
+            return l && l->test( p.x() * MAPSIZE_Y + p.y() );
+        }
+
+    private:
+        using layer = std::bitset<MAPSIZE_X * MAPSIZE_Y>;
+        std::array<std::unique_ptr<layer>, OVERMAP_LAYERS> layers;
+};
+
+// The cheapest route from every point of an area to a single destination on the same z-level,
+// found by one search backwards from the destination (a Dijkstra map).  Any number of callers
+// sharing the destination, settings and avoid key can read their route off it.
+struct flow_field {
+    tripoint_bub_ms target;
+    pathfinding_settings settings;
+    size_t avoid_key = 0;
+    // Inclusive bounds of the area covered.
+    tripoint_bub_ms min;
+    tripoint_bub_ms max;
+    // For each point of the area, the cost of its route to target, or -1 if it has none.
+    std::vector<int> cost;
+    // For each point of the area, the index of the next point on its route.
+    std::vector<int> next;
+
+    bool contains( const tripoint_bub_ms &p ) const;
+    int index( const tripoint_bub_ms &p ) const;
+    tripoint_bub_ms point_at( int index ) const;
+    // Route from f, which must be in the area, to target; empty if there is none.
+    std::vector<tripoint_bub_ms> route_from( const tripoint_bub_ms &f ) const;
+};
+
+// Routes recently found by map::route for callers that can share them, see the avoid_key
+// overload of map::route.  A route is forgotten when the turn ends, or as soon as the
+// pathfinding data of a tile inside the area that was searched to find it changes.
+class route_cache
+{
+    public:
+        // If f lies on a cached route to t that was found with the same settings and avoid key,
+        // returns the rest of that route after f.
+        std::optional<std::vector<tripoint_bub_ms>> find( const tripoint_bub_ms &f,
+                const tripoint_bub_ms &t, const pathfinding_settings &settings, size_t avoid_key );
+        // Remembers route, from f, found by searching the area between min and max (inclusive).
+        void add( const tripoint_bub_ms &f, const std::vector<tripoint_bub_ms> &route,
+                  const pathfinding_settings &settings, size_t avoid_key,
+                  const tripoint_bub_ms &min, const tripoint_bub_ms &max );
+
+        // Flow field towards t for these settings and avoid key, if one was built this turn.
+        const flow_field *find_field( const tripoint_bub_ms &t, const pathfinding_settings &settings,
+                                      size_t avoid_key );
+        // Notes that a route to t could not be answered from the cache.  Returns true once that
+        // has happened before during this turn, i.e. when several callers converge on t and a
+        // flow field is worth building.
+        bool wants_field( const tripoint_bub_ms &t, const pathfinding_settings &settings,
+                          size_t avoid_key );
+        const flow_field &add_field( flow_field &&field );
+
+        // Whether planning a route from f to t over submap portals failed earlier this turn.
+        bool portal_route_failed( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                  const pathfinding_settings &settings, size_t avoid_key );
+        void add_failed_portal_route( const tripoint_bub_ms &f, const tripoint_bub_ms &t,
+                                      const pathfinding_settings &settings, size_t avoid_key );
+
+        void invalidate( int zlev );
+        void invalidate( int zlev, const std::unordered_set<point_bub_ms> &points );
+
+    private:
+        struct entry {
+            // The origin, followed by the route itself.
+            std::vector<tripoint_bub_ms> points;
+            pathfinding_settings settings;
+            size_t avoid_key;
+            tripoint_bub_ms min;
+            tripoint_bub_ms max;
+        };
+        struct field_request {
+            tripoint_bub_ms target;
+            pathfinding_settings settings;
+            size_t avoid_key;
+        };
+        struct failed_route {
+            tripoint_bub_ms from;
+            tripoint_bub_ms to;
+            pathfinding_settings settings;
+            size_t avoid_key;
+        };
+        void expire_old_turns();
+        void drop_failed_portal_routes( int zlev );
+
+        std::vector<entry> entries;
+        std::vector<field_request> field_requests;
+        std::vector<flow_field> fields;
+        std::vector<failed_route> failed_portal_routes;
+        time_point turn;
 };
 
 #endif // CATA_SRC_PATHFINDING_H
@@ -196,13 +196,30 @@ cata_default_random_engine::result_type rng_get_first_seed()
     return static_cast<cata_default_random_engine::result_type>( seed );
 }
 
+// Engine installed by scoped_rng_engine on this thread, if any.
+static thread_local cata_default_random_engine *rng_engine_override = nullptr;
+
 cata_default_random_engine &rng_get_engine()
 {
+    if( rng_engine_override != nullptr ) {
+        return *rng_engine_override;
+    }
     // NOLINTNEXTLINE(cata-determinism)
     static cata_default_random_engine eng( rng_get_first_seed() );
     return eng;
 }
 
+scoped_rng_engine::scoped_rng_engine( cata_default_random_engine &engine )
+    : previous( rng_engine_override )
+{
+    rng_engine_override = &engine;
+}
+
+scoped_rng_engine::~scoped_rng_engine()
+{
+    rng_engine_override = previous;
+}
+
 void rng_set_engine_seed( unsigned int seed )
 {
     if( seed != 0 ) {
@@ -30,6 +30,23 @@ cata_default_random_engine::result_type rng_get_first_seed();
 cata_default_random_engine &rng_get_engine();
 unsigned int rng_bits();
 
+/**
+ * While alive, makes rng_get_engine() on the current thread return engine instead of the
+ * global one.  Lets work that is split over threads draw its numbers from engines seeded up
+ * front, so that the results do not depend on how the work was scheduled.
+ */
+class scoped_rng_engine
+{
+    public:
+        explicit scoped_rng_engine( cata_default_random_engine &engine );
+        scoped_rng_engine( const scoped_rng_engine & ) = delete;
+        scoped_rng_engine &operator=( const scoped_rng_engine & ) = delete;
+        ~scoped_rng_engine();
+
+    private:
+        cata_default_random_engine *previous;
+};
+
 int rng( int lo, int hi );
 double rng_float( double lo, double hi );
 
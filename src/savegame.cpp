@@ -1,6 +1,7 @@
 #include "game.h" // IWYU pragma: associated
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <map>
 #include <sstream>
@@ -154,6 +155,20 @@ void game::serialize( std::ostream &fout )
     json.end_object();
 }
 
+// Player's level first, then the others from the bottom up.
+static std::array<int, SCENT_MAP_Z_LEVELS> scent_layer_save_order()
+{
+    std::array<int, SCENT_MAP_Z_LEVELS> order;
+    order[0] = SCENT_MAP_Z_REACH;
+    int next = 1;
+    for( int layer = 0; layer < SCENT_MAP_Z_LEVELS; ++layer ) {
+        if( layer != SCENT_MAP_Z_REACH ) {
+            order[next++] = layer;
+        }
+    }
+    return order;
+}
+
 std::string scent_map::serialize( bool is_type ) const
 {
     std::ostringstream rle_out;
@@ -161,23 +176,29 @@ std::string scent_map::serialize( bool is_type ) const
     if( is_type ) {
         rle_out << typescent.str();
     } else {
-        int rle_lastval = -1;
-        int rle_count = 0;
-        for( const auto &elem : grscent ) {
-            for( const int &val : elem ) {
-                if( val == rle_lastval ) {
-                    rle_count++;
-                } else {
-                    if( rle_count ) {
-                        rle_out << rle_count << " ";
+        // The player's level comes first, as it was the only one in older saves.
+        for( const int layer : scent_layer_save_order() ) {
+            if( layer != SCENT_MAP_Z_REACH ) {
+                rle_out << " ";
+            }
+            int rle_lastval = -1;
+            int rle_count = 0;
+            for( const auto &elem : grscent[layer] ) {
+                for( const int &val : elem ) {
+                    if( val == rle_lastval ) {
+                        rle_count++;
+                    } else {
+                        if( rle_count ) {
+                            rle_out << rle_count << " ";
+                        }
+                        rle_out << val << " ";
+                        rle_lastval = val;
+                        rle_count = 1;
                     }
-                    rle_out << val << " ";
-                    rle_lastval = val;
-                    rle_count = 1;
                 }
             }
+            rle_out << rle_count;
         }
-        rle_out << rle_count;
     }
 
     return rle_out.str();
@@ -304,15 +325,19 @@ void scent_map::deserialize( const std::string &data, bool is_type )
         buffer >> str;
         typescent = scenttype_id( str );
     } else {
-        int stmp = 0;
-        int count = 0;
-        for( auto &elem : grscent ) {
-            for( int &val : elem ) {
-                if( count == 0 ) {
-                    buffer >> stmp >> count;
+        for( const int layer : scent_layer_save_order() ) {
+            int stmp = 0;
+            int count = 0;
+            for( auto &elem : grscent[layer] ) {
+                for( int &val : elem ) {
+                    if( count == 0 && !( buffer >> stmp >> count ) ) {
+                        // Saves from before other levels were kept end early.
+                        stmp = 0;
+                        count = MAPSIZE_X * MAPSIZE_Y;
+                    }
+                    count--;
+                    val = stmp;
                 }
-                count--;
-                val = stmp;
             }
         }
     }
@@ -1746,6 +1771,7 @@ void creature_tracker::deserialize( const JsonArray &ja )
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     for( JsonValue jv : ja ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
         shared_ptr_fast<monster> mptr = make_shared_fast<monster>();
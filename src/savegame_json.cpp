@@ -272,44 +272,46 @@ void item_pocket::deserialize( const JsonObject &data )
 
 void item_pocket::favorite_settings::serialize( JsonOut &json ) const
 {
+    const settings_values &v = get();
     json.start_object();
-    json.member( "name", preset_name );
-    json.member( "priority", priority_rating );
-    json.member( "item_whitelist", item_whitelist );
-    json.member( "item_blacklist", item_blacklist );
-    json.member( "category_whitelist", category_whitelist );
-    json.member( "category_blacklist", category_blacklist );
-    json.member( "collapsed", collapsed );
-    json.member( "disabled", disabled );
-    json.member( "unload", unload );
-    json.member( "player_edited", player_edited );
+    json.member( "name", v.preset_name );
+    json.member( "priority", v.priority_rating );
+    json.member( "item_whitelist", v.item_whitelist );
+    json.member( "item_blacklist", v.item_blacklist );
+    json.member( "category_whitelist", v.category_whitelist );
+    json.member( "category_blacklist", v.category_blacklist );
+    json.member( "collapsed", v.collapsed );
+    json.member( "disabled", v.disabled );
+    json.member( "unload", v.unload );
+    json.member( "player_edited", v.player_edited );
     json.end_object();
 }
 
 void item_pocket::favorite_settings::deserialize( const JsonObject &data )
 {
     data.allow_omitted_members();
+    settings_values &v = edit();
     if( data.has_member( "name" ) ) {
-        data.read( "name", preset_name );
+        data.read( "name", v.preset_name );
     }
-    data.read( "priority", priority_rating );
-    data.read( "item_whitelist", item_whitelist );
-    data.read( "item_blacklist", item_blacklist );
-    data.read( "category_whitelist", category_whitelist );
-    data.read( "category_blacklist", category_blacklist );
+    data.read( "priority", v.priority_rating );
+    data.read( "item_whitelist", v.item_whitelist );
+    data.read( "item_blacklist", v.item_blacklist );
+    data.read( "category_whitelist", v.category_whitelist );
+    data.read( "category_blacklist", v.category_blacklist );
     if( data.has_member( "collapsed" ) ) {
-        data.read( "collapsed", collapsed );
+        data.read( "collapsed", v.collapsed );
     }
     if( data.has_member( "disabled" ) ) {
-        data.read( "disabled", disabled );
+        data.read( "disabled", v.disabled );
     }
     if( data.has_member( "unload" ) ) {
-        data.read( "unload", unload );
+        data.read( "unload", v.unload );
     }
     if( data.has_member( "player_edited" ) ) {
-        data.read( "player_edited", player_edited );
+        data.read( "player_edited", v.player_edited );
     } else {
-        player_edited = true;
+        v.player_edited = true;
     }
 }
 
@@ -2827,19 +2829,20 @@ void item::io( Archive &archive )
     archive.io( "item_vars", item_vars, io::empty_default_tag() );
 
     // game::legacy_migrate_npctalk_var_prefix( item_vars );
-    // doesn't work here, because item_vars is cata::heap<std::map<>>, not std::unordered_map<>
+    // doesn't work here, because item_vars is an item_var_map, not std::unordered_map<>
     // remove after 0.J
     if( savegame_loading_version < 36 ) {
         const std::string prefix = "npctalk_var_";
-        for( auto i = item_vars.begin(); i != item_vars.end(); ) {
-            if( i->first.rfind( prefix, 0 ) == 0 ) {
-                std::map<std::string, std::string>::node_type extracted = ( *item_vars ).extract( i++ );
-                std::string new_key = extracted.key().substr( prefix.size() );
-                extracted.key() = new_key;
-                item_vars.insert( std::move( extracted ) );
-            } else {
-                ++i;
+        std::vector<std::pair<std::string, item_var_map::var_value>> renamed;
+        item_vars.erase_if( [&]( const std::string & name, const item_var_map::var_value & value ) {
+            if( name.rfind( prefix, 0 ) != 0 ) {
+                return false;
             }
+            renamed.emplace_back( name.substr( prefix.size() ), value );
+            return true;
+        } );
+        for( std::pair<std::string, item_var_map::var_value> &var : renamed ) {
+            item_vars.set( var.first, std::move( var.second ) );
         }
     }
     // TODO: change default to empty string
@@ -2997,13 +3000,9 @@ void item::io( Archive &archive )
     // Books without any chapters don't need to store a remaining-chapters
     // counter, it will always be 0 and it prevents proper stacking.
     if( get_chapters() == 0 ) {
-        for( auto it = item_vars.begin(); it != item_vars.end(); ) {
-            if( it->first.compare( 0, 19, "remaining-chapters-" ) == 0 ) {
-                item_vars.erase( it++ );
-            } else {
-                ++it;
-            }
-        }
+        item_vars.erase_if( []( const std::string & name, const item_var_map::var_value & ) {
+            return name.compare( 0, 19, "remaining-chapters-" ) == 0;
+        } );
     }
 
     static const std::set<std::string> removed_item_vars = {
@@ -3,10 +3,12 @@
 #include <algorithm>
 #include <cstdlib>
 #include <new>
+#include <vector>
 
 #include "assign.h"
 #include "calendar.h"
 #include "cata_assert.h"
+#include "cata_thread_pool.h"
 #include "color.h"
 #include "cuboid_rectangle.h"
 #include "cursesdef.h"
@@ -49,11 +51,19 @@ static nc_color sev( const size_t level )
     return level < colors.size() ? colors[level] : c_dark_gray;
 }
 
+// Index into grscent of the layer of z-level z.
+static int scent_layer( const int z )
+{
+    return z - get_map().get_abs_sub().z() + SCENT_MAP_Z_REACH;
+}
+
 void scent_map::reset()
 {
-    for( auto &elem : grscent ) {
-        for( int &val : elem ) {
-            val = 0;
+    for( scent_array<int> &layer : grscent ) {
+        for( auto &elem : layer ) {
+            for( int &val : elem ) {
+                val = 0;
+            }
         }
     }
     typescent = scenttype_id();
@@ -61,9 +71,11 @@ void scent_map::reset()
 
 void scent_map::decay()
 {
-    for( auto &elem : grscent ) {
-        for( int &val : elem ) {
-            val = std::max( 0, val - 1 );
+    for( scent_array<int> &layer : grscent ) {
+        for( auto &elem : layer ) {
+            for( int &val : elem ) {
+                val = std::max( 0, val - 1 );
+            }
         }
     }
 }
@@ -91,17 +103,37 @@ void scent_map::shift( const point &sm_shift )
     const int y_stop = sm_shift.y >= 0 ? MAPSIZE_Y : -1;
     const int y_step = sm_shift.y >= 0 ? 1 : -1;
 
-    for( int x = x_start; x != x_stop; x += x_step ) {
-        for( int y = y_start; y != y_stop; y += y_step ) {
-            const point p = point( x, y ) + sm_shift;
-            grscent[x][y] = inbounds( p ) ? grscent[p.x][p.y] : 0;
+    for( scent_array<int> &layer : grscent ) {
+        for( int x = x_start; x != x_stop; x += x_step ) {
+            for( int y = y_start; y != y_stop; y += y_step ) {
+                const point p = point( x, y ) + sm_shift;
+                layer[x][y] = inbounds( p ) ? layer[p.x][p.y] : 0;
+            }
+        }
+    }
+}
+
+void scent_map::vertical_shift( const int z_shift )
+{
+    // As above, move each layer before it is overwritten.
+    const int i_start = z_shift >= 0 ? 0 : SCENT_MAP_Z_LEVELS - 1;
+    const int i_stop = z_shift >= 0 ? SCENT_MAP_Z_LEVELS : -1;
+    const int i_step = z_shift >= 0 ? 1 : -1;
+    for( int i = i_start; i != i_stop; i += i_step ) {
+        const int from = i + z_shift;
+        if( from >= 0 && from < SCENT_MAP_Z_LEVELS ) {
+            grscent[i] = grscent[from];
+        } else {
+            for( auto &elem : grscent[i] ) {
+                elem.fill( 0 );
+            }
         }
     }
 }
 
 int scent_map::get( const tripoint &p ) const
 {
-    if( inbounds( p ) && grscent[p.x][p.y] > 0 ) {
+    if( inbounds( p ) && grscent[scent_layer( p.z )][p.x][p.y] > 0 ) {
         return get_unsafe( p );
     }
     return 0;
@@ -121,14 +153,14 @@ void scent_map::set( const tripoint &p, int value, const scenttype_id &type )
 
 void scent_map::set_unsafe( const tripoint &p, int value, const scenttype_id &type )
 {
-    grscent[p.x][p.y] = value;
+    grscent[scent_layer( p.z )][p.x][p.y] = value;
     if( !type.is_empty() ) {
         typescent = type;
     }
 }
 int scent_map::get_unsafe( const tripoint &p ) const
 {
-    return grscent[p.x][p.y] - std::abs( get_map().get_abs_sub().z() - p.z );
+    return grscent[scent_layer( p.z )][p.x][p.y];
 }
 
 scenttype_id scent_map::get_type() const
@@ -139,7 +171,7 @@ scenttype_id scent_map::get_type() const
 scenttype_id scent_map::get_type( const tripoint &p ) const
 {
     scenttype_id id;
-    if( inbounds( p ) && grscent[p.x][p.y] > 0 ) {
+    if( inbounds( p ) && grscent[scent_layer( p.z )][p.x][p.y] > 0 ) {
         id = typescent;
     }
     return id;
@@ -147,14 +179,8 @@ scenttype_id scent_map::get_type( const tripoint &p ) const
 
 bool scent_map::inbounds( const tripoint &p ) const
 {
-    // HACK: This weird long check here is a hack around the fact that scentmap is 2D
-    // A z-level can access scentmap if it is within SCENT_MAP_Z_REACH flying z-level move from player's z-level
-    // That is, if a flying critter could move directly up or down (or stand still) and be on same z-level as player
-    const int levz = get_map().get_abs_sub().z();
-    const bool scent_map_z_level_inbounds = ( p.z == levz ) ||
-                                            ( std::abs( p.z - levz ) == SCENT_MAP_Z_REACH &&
-                                                    get_map().valid_move( p, tripoint( p.xy(), levz ), false, true ) );
-    if( !scent_map_z_level_inbounds ) {
+    const int layer = scent_layer( p.z );
+    if( layer < 0 || layer >= SCENT_MAP_Z_LEVELS ) {
         return false;
     }
     return inbounds( p.xy() );
@@ -182,91 +208,154 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
-
     // these are for caching flag lookups
-    scent_array<bool> blocks_scent; // currently only ter_furn_flag::TFLAG_NO_SCENT blocks scent
-    scent_array<bool> reduces_scent;
+    struct level_flags {
+        // currently only ter_furn_flag::TFLAG_NO_SCENT blocks scent
+        scent_array<bool> blocks_scent;
+        scent_array<bool> reduces_scent;
+        // where scent passes to the level above
+        scent_array<bool> links_up;
+    };
+    std::vector<level_flags> flags( SCENT_MAP_Z_LEVELS );
+    std::array<bool, SCENT_MAP_Z_LEVELS> level_exists;
+
+    const point scentmap_min( center.x - SCENT_RADIUS, center.y - SCENT_RADIUS );
+    const point scentmap_max( center.x + SCENT_RADIUS, center.y + SCENT_RADIUS );
+    const int levz = m.get_abs_sub().z();
+
+    for( int i = 0; i < SCENT_MAP_Z_LEVELS; ++i ) {
+        const int z = levz - SCENT_MAP_Z_REACH + i;
+        level_exists[i] = z >= -OVERMAP_DEPTH && z <= OVERMAP_HEIGHT;
+        if( level_exists[i] ) {
+            // The new scent flag searching function. Should be wayyy faster than the old one.
+            m.scent_blockers( flags[i].blocks_scent, flags[i].reduces_scent,
+                              point_bub_ms( scentmap_min + point::north_west ),
+                              point_bub_ms( scentmap_max + point::south_east ), z );
+        }
+    }
+    for( int i = 0; i + 1 < SCENT_MAP_Z_LEVELS; ++i ) {
+        if( !level_exists[i] || !level_exists[i + 1] ) {
+            continue;
+        }
+        scent_array<bool> &links = flags[i].links_up;
+        m.scent_vertical_links( links, point_bub_ms( scentmap_min ), point_bub_ms( scentmap_max ),
+                                levz - SCENT_MAP_Z_REACH + i );
+        for( int x = scentmap_min.x; x <= scentmap_max.x; ++x ) {
+            for( int y = scentmap_min.y; y <= scentmap_max.y; ++y ) {
+                links[x][y] = links[x][y] && !flags[i].blocks_scent[x][y] &&
+                              !flags[i + 1].blocks_scent[x][y];
+            }
+        }
+    }
 
-    // for loop constants
-    const int scentmap_minx = center.x - SCENT_RADIUS;
-    const int scentmap_maxx = center.x + SCENT_RADIUS;
-    const int scentmap_miny = center.y - SCENT_RADIUS;
-    const int scentmap_maxy = center.y + SCENT_RADIUS;
+    // The levels only interact through the vertical exchange, so spread them on the worker pool.
+    cata::parallel_for( SCENT_MAP_Z_LEVELS, [&]( size_t i ) {
+        if( level_exists[i] ) {
+            diffuse( grscent[i], flags[i].blocks_scent, flags[i].reduces_scent,
+                     scentmap_min, scentmap_max );
+        }
+    } );
+    for( int i = 0; i + 1 < SCENT_MAP_Z_LEVELS; ++i ) {
+        if( level_exists[i] && level_exists[i + 1] ) {
+            diffuse_vertically( grscent[i], grscent[i + 1], flags[i].links_up,
+                                scentmap_min, scentmap_max );
+        }
+    }
+}
 
+void scent_map::diffuse_vertically( scent_array<int> &lower, scent_array<int> &upper,
+                                    const scent_array<bool> &links,
+                                    const point &min, const point &max )
+{
+    // A quarter of the difference between the two squares crosses each turn.
+    const int vertical_divisor = 4;
+    const int min_y = min.y;
+    const int max_y = max.y;
+    for( int x = min.x; x <= max.x; ++x ) {
+        std::array<int, MAPSIZE_Y> &lower_col = lower[x];
+        std::array<int, MAPSIZE_Y> &upper_col = upper[x];
+        const std::array<bool, MAPSIZE_Y> &links_col = links[x];
+        for( int y = min_y; y <= max_y; ++y ) {
+            const int flow = links_col[y] * ( lower_col[y] - upper_col[y] ) / vertical_divisor;
+            lower_col[y] -= flow;
+            upper_col[y] += flow;
+        }
+    }
+}
+
+void scent_map::diffuse( scent_array<int> &scent, const scent_array<bool> &blocks_scent,
+                         const scent_array<bool> &reduces_scent,
+                         const point &min, const point &max )
+{
     // decrease this to reduce gas spread. Keep it under 125 for
     // stability. This is essentially a decimal number * 1000.
     const int diffusivity = 100;
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent, point_bub_ms( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point_bub_ms( scentmap_maxx + 1, scentmap_maxy + 1 ) );
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
-    // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
-    // MAPSIZE_X, but if that changes, this may need tweaking.
-    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+    // times.  Scent arrays are indexed [x][y], so every column is contiguous in memory; both
+    // passes walk columns with branch-free inner loops the compiler can vectorize.
+    // note: this needs the flags of a border one square wide around the final scent matrix.
+    scent_array<int> sum_3_scent;
+    scent_array<int> squares_used;
+    // How much of the scent of a square diffuses into its neighbors, per column.
+    std::array<int, MAPSIZE_Y> weight;
+    std::array<int, MAPSIZE_Y> weighted_scent;
+    // Copies, as the bounds could otherwise alias the scent written in the loops.
+    const int min_x = min.x;
+    const int min_y = min.y;
+    const int max_x = max.x;
+    const int max_y = max.y;
+    for( int x = min_x - 1; x <= max_x + 1; ++x ) {
+        const std::array<bool, MAPSIZE_Y> &blocks = blocks_scent[x];
+        const std::array<bool, MAPSIZE_Y> &reduces = reduces_scent[x];
+        const std::array<int, MAPSIZE_Y> &scent_col = scent[x];
+        for( int y = min_y - 1; y <= max_y + 1; ++y ) {
+            // Flags are turned into 0/1 factors instead of being branched on.
+            const int passes = 1 - blocks[y];
+            // only 20% of scent can diffuse on REDUCE_SCENT squares
+            weight[y] = passes * ( 10 - 8 * reduces[y] );
+            weighted_scent[y] = weight[y] * scent_col[y];
+        }
+        std::array<int, MAPSIZE_Y> &sum_col = sum_3_scent[x];
+        std::array<int, MAPSIZE_Y> &used_col = squares_used[x];
+        for( int y = min_y; y <= max_y; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum_col[y] = weighted_scent[y - 1] + weighted_scent[y] + weighted_scent[y + 1];
+            used_col[y] = weight[y - 1] + weight[y] + weight[y + 1];
         }
     }
 
     // Rest of the scent map
-    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            int &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring REDUCE_SCENT squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent via NO_SCENT (in json)
-                scent_here = 0;
-            }
+    for( int x = min_x; x <= max_x; ++x ) {
+        const std::array<bool, MAPSIZE_Y> &blocks = blocks_scent[x];
+        const std::array<bool, MAPSIZE_Y> &reduces = reduces_scent[x];
+        const std::array<int, MAPSIZE_Y> &sum_west = sum_3_scent[x - 1];
+        const std::array<int, MAPSIZE_Y> &sum_here = sum_3_scent[x];
+        const std::array<int, MAPSIZE_Y> &sum_east = sum_3_scent[x + 1];
+        const std::array<int, MAPSIZE_Y> &used_west = squares_used[x - 1];
+        const std::array<int, MAPSIZE_Y> &used_here = squares_used[x];
+        const std::array<int, MAPSIZE_Y> &used_east = squares_used[x + 1];
+        std::array<int, MAPSIZE_Y> &scent_col = scent[x];
+        for( int y = min_y; y <= max_y; ++y ) {
+            const int scent_here = scent_col[y];
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares = used_west[y] + used_here[y] + used_east[y];
+            //less air movement for REDUCE_SCENT square
+            const int this_diffusivity = diffusivity
+                                         - ( diffusivity - diffusivity / 5 ) * reduces[y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares * this_diffusivity );
+            // neighboring REDUCE_SCENT squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int diffused = ( temp_scent
+                                   + this_diffusivity * ( sum_west[y] + sum_here[y] + sum_east[y] )
+                                 ) / ( 1000 * 10 );
+            // this cell blocks scent via NO_SCENT (in json)
+            scent_col[y] = ( 1 - blocks[y] ) * diffused;
         }
     }
 }
@@ -17,7 +17,9 @@
 
 class JsonObject;
 
+// Scent is kept for the z-levels up to this far above and below the player's.
 constexpr int SCENT_MAP_Z_REACH = 1;
+constexpr int SCENT_MAP_Z_LEVELS = 2 * SCENT_MAP_Z_REACH + 1;
 
 class game;
 class map;
@@ -44,11 +46,13 @@ class scent_type
 
 class scent_map
 {
-    protected:
+    public:
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
-        scent_array<int> grscent;
+    protected:
+        // One layer per z-level, from SCENT_MAP_Z_REACH below the player's level upwards.
+        std::array<scent_array<int>, SCENT_MAP_Z_LEVELS> grscent;
         scenttype_id typescent;
         std::optional<tripoint> player_last_position; // NOLINT(cata-serialize)
         time_point player_last_moved = calendar::before_time_starts; // NOLINT(cata-serialize)
@@ -64,9 +68,26 @@ class scent_map
         void draw( const catacurses::window &win, int div, const tripoint &center ) const;
 
         void update( const tripoint &center, map &m );
+        /**
+         * Spreads scent one turn within the rectangle [min, max], the scent diffusion step of
+         * @ref update.  blocks_scent and reduces_scent hold the NO_SCENT and REDUCE_SCENT flags
+         * and must be filled one square beyond the rectangle on each side.
+         */
+        static void diffuse( scent_array<int> &scent, const scent_array<bool> &blocks_scent,
+                             const scent_array<bool> &reduces_scent,
+                             const point &min, const point &max );
+        /**
+         * Exchanges scent between two vertically adjacent layers within [min, max], at the
+         * squares where links is set, e.g. stairs or open air above the lower square.
+         */
+        static void diffuse_vertically( scent_array<int> &lower, scent_array<int> &upper,
+                                        const scent_array<bool> &links,
+                                        const point &min, const point &max );
         void reset();
         void decay();
         void shift( const point &sm_shift );
+        /** Moves the layers along when the map is shifted z_shift levels up (or down). */
+        void vertical_shift( int z_shift );
 
         /**
          * Get the scent value at the given position.
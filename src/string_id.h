@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_STRING_ID_H
 #define CATA_SRC_STRING_ID_H
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -345,16 +346,40 @@ public:
     }
 
 private:
-    // generic_factory version that corresponds to the _cid
-    mutable int64_t _version = INVALID_VERSION;
-    // cached int_id counterpart of this string_id
-    mutable int _cid = INVALID_CID;
+    // Lookups fill the cache from const functions, which may run on several threads at once
+    // (e.g. concurrent loading stages), so both halves are atomic.  The cid is stored before the
+    // version and read after it, so a matching version always comes with its own cid.
+    struct cid_cache {
+        // generic_factory version that corresponds to the cid
+        std::atomic<int64_t> version{ INVALID_VERSION };
+        // cached int_id counterpart of this string_id
+        std::atomic<int> cid{ INVALID_CID };
+
+        cid_cache() = default;
+        cid_cache( const cid_cache &rhs ) noexcept :
+            version( rhs.version.load( std::memory_order_acquire ) ),
+            cid( rhs.cid.load( std::memory_order_relaxed ) ) {}
+        cid_cache &operator=( const cid_cache &rhs ) noexcept {
+            const int64_t v = rhs.version.load( std::memory_order_acquire );
+            cid.store( rhs.cid.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            version.store( v, std::memory_order_release );
+            return *this;
+        }
+    };
+    mutable cid_cache _cache;
     // structure that captures the actual "identity" of this string_id
     Identity _id;
 
+    inline bool get_cid( int64_t version, int &cid ) const {
+        if( _cache.version.load( std::memory_order_acquire ) != version ) {
+            return false;
+        }
+        cid = _cache.cid.load( std::memory_order_relaxed );
+        return true;
+    }
     inline void set_cid_version( int cid, int64_t version ) const {
-        _cid = cid;
-        _version = version;
+        _cache.cid.store( cid, std::memory_order_relaxed );
+        _cache.version.store( version, std::memory_order_release );
     }
 
     friend class generic_factory<T>;
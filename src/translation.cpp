@@ -3,6 +3,7 @@
 #include <regex>
 
 #include "cached_options.h"
+#include "cata_thread_pool.h"
 #include "cata_utility.h"
 #include "debug.h"
 #include "generic_factory.h"
@@ -296,6 +297,10 @@ std::string translation::translated( const int num ) const
     if( !needs_translation || raw.empty() ) {
         return raw;
     }
+    // The cache is not synchronized, so worker threads do without it.
+    if( cata::in_parallel_task() ) {
+        return translate_uncached( num );
+    }
     // Note1: `raw`, `raw_pl` and `ctxt` are effectively immutable for caching purposes:
     // in the places where they are changed, cache is explicitly invalidated
     // Note2: if `raw_pl` is defined, `num` becomes part of the "cache key"
@@ -304,24 +309,26 @@ std::string translation::translated( const int num ) const
         ( raw_pl && cached_num != num ) || !cached_translation ) {
         cached_language_version = detail::get_current_language_version();
         cached_num = num;
+        cached_translation = cata::make_value<std::string>( translate_uncached( num ) );
+    }
+    return *cached_translation;
+}
 
-        if( !ctxt ) {
-            if( !raw_pl ) {
-                cached_translation = cata::make_value<std::string>( detail::_translate_internal( raw ) );
-            } else {
-                cached_translation = cata::make_value<std::string>(
-                                         n_gettext( raw.c_str(), raw_pl->c_str(), num ) );
-            }
+std::string translation::translate_uncached( const int num ) const
+{
+    if( !ctxt ) {
+        if( !raw_pl ) {
+            return detail::_translate_internal( raw );
         } else {
-            if( !raw_pl ) {
-                cached_translation = cata::make_value<std::string>( pgettext( ctxt->c_str(), raw.c_str() ) );
-            } else {
-                cached_translation = cata::make_value<std::string>(
-                                         npgettext( ctxt->c_str(), raw.c_str(), raw_pl->c_str(), num ) );
-            }
+            return n_gettext( raw.c_str(), raw_pl->c_str(), num );
+        }
+    } else {
+        if( !raw_pl ) {
+            return pgettext( ctxt->c_str(), raw.c_str() );
+        } else {
+            return npgettext( ctxt->c_str(), raw.c_str(), raw_pl->c_str(), num );
         }
     }
-    return *cached_translation;
 }
 
 bool translation::empty() const
@@ -143,6 +143,8 @@ class translation
         struct no_translation_tag {};
         translation( const std::string &str, no_translation_tag );
 
+        std::string translate_uncached( int num ) const;
+
         cata::value_ptr<std::string> ctxt;
         std::string raw;
         cata::value_ptr<std::string> raw_pl;
@@ -955,9 +955,20 @@ units::temperature weather_manager::get_temperature( const tripoint &location )
         return *forced_temperature;
     }
 
-    const auto &cached = temperature_cache.find( location );
-    if( cached != temperature_cache.end() ) {
-        return cached->second;
+    temperature_cell *cell = nullptr;
+    if( location.x >= 0 && location.x < MAPSIZE_X && location.y >= 0 && location.y < MAPSIZE_Y &&
+        location.z >= -OVERMAP_DEPTH && location.z <= OVERMAP_HEIGHT ) {
+        if( temperature_cache.empty() ) {
+            temperature_cache.resize( OVERMAP_LAYERS );
+        }
+        std::vector<temperature_cell> &level = temperature_cache[location.z + OVERMAP_DEPTH];
+        if( level.empty() ) {
+            level.resize( static_cast<size_t>( MAPSIZE_X ) * MAPSIZE_Y );
+        }
+        cell = &level[location.x + location.y * MAPSIZE_X];
+        if( cell->stamp == temperature_stamp ) {
+            return cell->temperature;
+        }
     }
 
     //underground temperature = average New England temperature = 43F/6C
@@ -972,7 +983,10 @@ units::temperature weather_manager::get_temperature( const tripoint &location )
         temp += temp_mod;
     }
 
-    temperature_cache.emplace( location, temp );
+    if( cell != nullptr ) {
+        cell->temperature = temp;
+        cell->stamp = temperature_stamp;
+    }
     return temp;
 }
 
@@ -983,7 +997,15 @@ units::temperature weather_manager::get_temperature( const tripoint_abs_omt &loc
 
 void weather_manager::clear_temp_cache()
 {
-    temperature_cache.clear();
+    if( ++temperature_stamp == 0 ) {
+        // Wrapped around, so old cells could look current.
+        for( std::vector<temperature_cell> &level : temperature_cache ) {
+            for( temperature_cell &cell : level ) {
+                cell.stamp = 0;
+            }
+        }
+        temperature_stamp = 1;
+    }
 }
 
 const weather_manager &get_weather_const()
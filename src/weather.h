@@ -221,15 +221,27 @@ class weather_manager
         void set_nextweather( time_point t );
         // The time at which weather will shift next.
         time_point nextweather;
-        /** temperature cache, cleared every turn, sparse map of map tripoints to temperatures */
-        std::unordered_map< tripoint, units::temperature > temperature_cache;
         // Returns outdoor or indoor temperature of given location
         units::temperature get_temperature( const tripoint &location );
         // Returns outdoor or indoor temperature of given location
         units::temperature get_temperature( const tripoint_abs_omt &location ) const;
+        /** Forgets the temperatures looked up so far, done every turn. */
         void clear_temp_cache();
         static void serialize_all( JsonOut &json );
         static void unserialize_all( const JsonObject &w );
+    private:
+        struct temperature_cell {
+            units::temperature temperature = 0_K;
+            // The temperature_stamp the cell was filled at.
+            unsigned int stamp = 0;
+        };
+        /**
+         * Temperatures of the map tiles looked up this turn, a dense grid for each z-level of
+         * the reality bubble that is allocated when it is first used.  A cell only counts if its
+         * stamp is the current one, so that clearing the cache does not touch the grids.
+         */
+        std::vector<std::vector<temperature_cell>> temperature_cache;
+        unsigned int temperature_stamp = 1;
 };
 
 weather_manager &get_weather();
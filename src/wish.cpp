@@ -50,6 +50,11 @@
 #include "uistate.h"
 #include "units.h"
 
+#if defined(TILES)
+#include "cata_tiles.h"
+#include "sdltiles.h"
+#endif
+
 static const efftype_id effect_pet( "pet" );
 
 static const mongroup_id GROUP_ZOMBIE( "GROUP_ZOMBIE" );
@@ -830,6 +835,10 @@ void debug_menu::wishmonster( const std::optional<tripoint> &p )
                     }
                     ++num_spawned;
                 }
+#if defined(TILES)
+                // Mark cata_tiles draw caches as dirty
+                tilecontext->set_draw_cache_dirty();
+#endif
                 input_context ctxt( wmenu.input_category, keyboard_mode::keycode );
                 cb.msg = string_format( _( "Spawned %d monsters, choose another or [%s] to quit." ),
                                         num_spawned, ctxt.get_desc( "QUIT" ) );
@@ -1170,6 +1179,10 @@ void debug_menu::wishitem( Character *you, const tripoint &pos )
                     get_map().add_item_or_charges( pos, granted );
                     wmenu.ret = -1;
                 }
+#if defined(TILES)
+                // Mark cata_tiles draw caches as dirty
+                tilecontext->set_draw_cache_dirty();
+#endif
                 if( amount > 0 ) {
                     input_context ctxt( wmenu.input_category, keyboard_mode::keycode );
                     cb.msg = string_format( _( "Wish granted.  Wish for more or hit [%s] to quit." ),
@@ -1,5 +1,8 @@
+#include <list>
+#include <map>
 #include <set>
 
+#include "active_item_cache.h"
 #include "calendar.h"
 #include "cata_catch.h"
 #include "game_constants.h"
@@ -40,3 +43,64 @@ TEST_CASE( "place_active_item_at_various_coordinates", "[item]" )
         }
     }
 }
+
+TEST_CASE( "active_items_are_processed_when_due", "[item][active_item]" )
+{
+    const time_point start = calendar::turn;
+    std::list<item> items;
+    for( int i = 0; i < 3; ++i ) {
+        items.emplace_back( "cookies" );
+    }
+    item &chainsaw = items.emplace_back( "chainsaw_on" );
+    chainsaw.active = true;
+    REQUIRE( items.front().processing_speed() == 600 );
+    REQUIRE( chainsaw.processing_speed() == 1 );
+
+    active_item_cache cache;
+    for( item &it : items ) {
+        CHECK( cache.add( it, point_sm_ms( 1, 1 ) ) );
+    }
+    // Adding again does nothing.
+    CHECK( cache.add( chainsaw, point_sm_ms( 1, 1 ) ) );
+    CHECK( cache.get().size() == items.size() );
+
+    std::map<const item *, int> processed;
+    const auto run = [&]( const int turns, const int step ) {
+        for( int turn = 0; turn < turns; turn += step ) {
+            calendar::turn += time_duration::from_turns( step );
+            for( const item_reference &ref : cache.get_for_processing() ) {
+                ++processed[ref.item_ref.get()];
+            }
+        }
+    };
+
+    run( 1200, 1 );
+    CHECK( processed[&chainsaw] == 1200 );
+    for( const item &it : items ) {
+        if( &it != &chainsaw ) {
+            CHECK( processed[&it] == 2 );
+        }
+    }
+
+    SECTION( "turns skipped" ) {
+        processed.clear();
+        run( 1200, 7 );
+        // Every item comes up once per call at most.
+        CHECK( processed[&chainsaw] == 1200 / 7 + 1 );
+        CHECK( processed[&items.front()] == 2 );
+    }
+    SECTION( "time jumps ahead" ) {
+        processed.clear();
+        run( 2, 100000 );
+        CHECK( processed.size() == items.size() );
+    }
+    SECTION( "destroyed items are dropped" ) {
+        items.pop_front();
+        CHECK( cache.get().size() == items.size() );
+        items.clear();
+        CHECK( cache.empty() );
+        run( 600, 1 );
+        CHECK( cache.get_for_processing().empty() );
+    }
+    calendar::turn = start;
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cached_options.h"
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "cata_thread_pool.h"
+#include "debug.h"
+
+TEST_CASE( "parallel_for_runs_every_index_once", "[thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    worker_threads = GENERATE( 1, 2, 4 );
+    CAPTURE( worker_threads );
+
+    const size_t count = 1000;
+    std::vector<int> hits( count, 0 );
+    cata::parallel_for( count, [&]( size_t i ) {
+        ++hits[i];
+    } );
+    for( size_t i = 0; i < count; ++i ) {
+        CHECK( hits[i] == 1 );
+    }
+}
+
+TEST_CASE( "parallel_for_nested_calls_run_serially", "[thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    worker_threads = 4;
+
+    CHECK_FALSE( cata::in_parallel_task() );
+    std::atomic<int> total{ 0 };
+    std::atomic<int> in_task{ 0 };
+    cata::parallel_for( 8, [&]( size_t ) {
+        // Catch assertions are not thread safe, so only count here.
+        if( cata::in_parallel_task() ) {
+            ++in_task;
+        }
+        cata::parallel_for( 8, [&]( size_t ) {
+            ++total;
+        } );
+    } );
+    CHECK( in_task == 8 );
+    CHECK( total == 64 );
+    CHECK_FALSE( cata::in_parallel_task() );
+}
+
+TEST_CASE( "parallel_for_rethrows_lowest_index_exception", "[thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    worker_threads = GENERATE( 1, 4 );
+    CAPTURE( worker_threads );
+
+    std::string what;
+    try {
+        cata::parallel_for( 100, []( size_t i ) {
+            if( i == 10 || i == 90 ) {
+                throw std::runtime_error( std::to_string( i ) );
+            }
+        } );
+    } catch( const std::runtime_error &e ) {
+        what = e.what();
+    }
+    CHECK( what == "10" );
+}
+
+TEST_CASE( "deferred_debugmsgs_are_replayed_in_order", "[thread_pool][debug]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    worker_threads = 4;
+
+    std::vector<std::vector<deferred_debugmsg>> messages( 4 );
+    cata::parallel_for( messages.size(), [&]( size_t i ) {
+        messages[i] = defer_debugmsgs_during( [i]() {
+            debugmsg( "message %d", static_cast<int>( i ) );
+        } );
+    } );
+    const std::string captured = capture_debugmsg_during( [&]() {
+        for( const std::vector<deferred_debugmsg> &msgs : messages ) {
+            replay_deferred_debugmsgs( msgs );
+        }
+    } );
+    CHECK( captured == "message 0message 1message 2message 3" );
+}
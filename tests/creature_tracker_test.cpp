@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "point.h"
+
+static std::set<const monster *> monsters_near( const tripoint_abs_ms &center, int radius )
+{
+    std::set<const monster *> found;
+    get_creature_tracker().for_each_monster_near( center, radius, 0, [&]( monster & critter ) {
+        found.insert( &critter );
+    } );
+    return found;
+}
+
+static std::set<const monster *> scan_monsters( const tripoint_abs_ms &center, int radius )
+{
+    std::set<const monster *> found;
+    for( const monster &critter : g->all_monsters() ) {
+        const tripoint_abs_ms &p = critter.get_location();
+        if( !critter.is_dead() && p.z() == center.z() &&
+            std::max( std::abs( p.x() - center.x() ), std::abs( p.y() - center.y() ) ) <= radius ) {
+            found.insert( &critter );
+        }
+    }
+    return found;
+}
+
+TEST_CASE( "monsters_near_a_point_match_a_full_scan", "[creature_tracker]" )
+{
+    clear_map();
+    map &here = get_map();
+    std::vector<monster *> spawned;
+    for( int x = 10; x < 125; x += 11 ) {
+        for( int y = 10; y < 125; y += 11 ) {
+            spawned.push_back( &spawn_test_monster( "mon_zombie", { x, y, 0 } ) );
+        }
+    }
+    const tripoint_abs_ms center = here.getglobal( tripoint_bub_ms( 60, 60, 0 ) );
+    const int radius = GENERATE( 0, 5, 20, 70 );
+    CAPTURE( radius );
+
+    CHECK( monsters_near( center, radius ) == scan_monsters( center, radius ) );
+
+    SECTION( "after monsters move" ) {
+        spawned[0]->setpos( tripoint_bub_ms( 61, 62, 0 ) );
+        spawned[1]->setpos( tripoint_bub_ms( 3, 120, 0 ) );
+        CHECK( monsters_near( center, radius ) == scan_monsters( center, radius ) );
+    }
+    SECTION( "after monsters die" ) {
+        for( monster *critter : spawned ) {
+            if( critter->pos_bub().x() < 60 ) {
+                critter->die( nullptr );
+            }
+        }
+        CHECK( monsters_near( center, radius ) == scan_monsters( center, radius ) );
+        get_creature_tracker().remove_dead();
+        CHECK( monsters_near( center, radius ) == scan_monsters( center, radius ) );
+    }
+    clear_map();
+}
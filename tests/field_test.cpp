@@ -1,13 +1,23 @@
+#include <algorithm>
+#include <cstdlib>
 #include <iosfwd>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "avatar.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_catch.h"
+#include "cata_scope_helpers.h"
 #include "effect.h"
 #include "field.h"
+#include "field_spread_grid.h"
 #include "field_type.h"
+#include "game_constants.h"
 #include "item.h"
+#include "level_cache.h"
+#include "line.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "map_iterator.h"
@@ -15,6 +25,7 @@
 #include "options_helpers.h"
 #include "player_helpers.h"
 #include "point.h"
+#include "rng.h"
 #include "type_id.h"
 #include "weather.h"
 
@@ -23,8 +34,10 @@ static const efftype_id effect_test_rash( "test_rash" );
 static const field_type_str_id field_fd_acid( "fd_acid" );
 static const field_type_str_id field_fd_test( "fd_test" );
 
+static const ter_str_id ter_t_floor( "t_floor" );
 static const ter_str_id ter_t_open_air( "t_open_air" );
 static const ter_str_id ter_t_tree_walnut( "t_tree_walnut" );
+static const ter_str_id ter_t_wall( "t_wall" );
 
 static int count_fields( const field_type_str_id &field_type )
 {
@@ -573,3 +586,245 @@ TEST_CASE( "player_single_effect_field_test_all", "[field][player]" )
     clear_avatar();
     fields_test_cleanup();
 }
+
+TEST_CASE( "field_changes_update_single_tiles_of_transparency_cache", "[field][vision]" )
+{
+    clear_map();
+    map &m = get_map();
+    const tripoint_bub_ms p = get_player_character().pos_bub() + tripoint_rel_ms( 5, 5, 0 );
+    const auto transparency = [&m, &p]() {
+        return m.access_cache( p.z() ).transparency_cache[p.x()][p.y()];
+    };
+    const auto vision_transparency = [&m, &p]() {
+        return m.access_cache( p.z() ).vision_transparency_cache[p.x()][p.y()];
+    };
+    m.build_map_cache( p.z(), true );
+    const float clear = transparency();
+
+    m.add_field( p, fd_smoke, 2 );
+    m.build_map_cache( p.z(), true );
+    const float smoky = transparency();
+    CHECK( smoky != clear );
+    CHECK( vision_transparency() == smoky );
+
+    // Same result as rebuilding the whole level.
+    m.set_transparency_cache_dirty( p.z() );
+    m.build_map_cache( p.z(), true );
+    CHECK( transparency() == smoky );
+    CHECK( vision_transparency() == smoky );
+
+    m.remove_field( p, fd_smoke );
+    m.build_map_cache( p.z(), true );
+    CHECK( transparency() == clear );
+    CHECK( vision_transparency() == clear );
+}
+
+TEST_CASE( "gas_spreads_the_same_with_any_number_of_threads", "[field][thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    const time_point before = calendar::turn;
+    map &m = get_map();
+    REQUIRE( fd_smoke->has_local_processing() );
+
+    const auto spread = [&m, &before]( const int threads ) {
+        worker_threads = threads;
+        calendar::turn = before;
+        clear_map( -1, 1 );
+        rng_set_engine_seed( 1234 );
+        // Clouds on and across the edges of several submaps.
+        for( int x = 10; x < 110; x += 23 ) {
+            for( int y = 10; y < 110; y += 17 ) {
+                m.add_field( tripoint_bub_ms( x, y, 0 ), fd_smoke, 3, 1_turns );
+            }
+        }
+        for( int i = 0; i < 20; ++i ) {
+            m.process_fields();
+            calendar::turn += 1_turns;
+        }
+        std::vector<std::pair<int, int>> result;
+        for( int z = -1; z <= 1; ++z ) {
+            for( const tripoint_bub_ms &p : m.points_on_zlevel( z ) ) {
+                const field_entry *smoke = m.get_field( p, fd_smoke );
+                if( smoke != nullptr && smoke->is_field_alive() ) {
+                    result.emplace_back( smoke->get_field_intensity(),
+                                         to_turns<int>( smoke->get_field_age() ) );
+                } else {
+                    result.emplace_back( 0, 0 );
+                }
+            }
+        }
+        return result;
+    };
+
+    const std::vector<std::pair<int, int>> serial = spread( 1 );
+    const std::vector<std::pair<int, int>> parallel = spread( 4 );
+    CHECK( std::count_if( serial.begin(), serial.end(), []( const std::pair<int, int> & f ) {
+        return f.first > 0;
+    } ) > 30 );
+    CHECK( serial == parallel );
+
+    calendar::turn = before;
+    clear_map();
+}
+
+// A closed room with a cloud of smoke in the middle.
+static void smoke_filled_room( map &m, const tripoint_bub_ms &center )
+{
+    for( const tripoint_bub_ms &p : m.points_in_radius( center, 8 ) ) {
+        const bool edge = std::abs( p.x() - center.x() ) == 8 || std::abs( p.y() - center.y() ) == 8;
+        m.ter_set( p, edge ? ter_t_wall : ter_t_floor );
+    }
+    for( const tripoint_bub_ms &p : m.points_in_radius( center, 2 ) ) {
+        m.add_field( p, fd_smoke, 3, 1_turns );
+    }
+}
+
+template<typename F>
+static void for_each_smoke( map &m, F &&func )
+{
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        for( const tripoint_bub_ms &p : m.points_on_zlevel( z ) ) {
+            const field_entry *smoke = m.get_field( p, fd_smoke );
+            if( smoke != nullptr && smoke->is_field_alive() ) {
+                func( p, *smoke );
+            }
+        }
+    }
+}
+
+static std::pair<int, time_duration> total_smoke( map &m )
+{
+    std::pair<int, time_duration> total( 0, 0_turns );
+    for_each_smoke( m, [&total]( const tripoint_bub_ms &, const field_entry & smoke ) {
+        total.first += smoke.get_field_intensity();
+        total.second += smoke.get_field_age();
+    } );
+    return total;
+}
+
+TEST_CASE( "gas_spread_grid_only_moves_gas", "[field]" )
+{
+    clear_map();
+    map &m = get_map();
+    const tripoint_bub_ms center( 60, 60, 0 );
+    smoke_filled_room( m, center );
+    const std::pair<int, time_duration> before = total_smoke( m );
+
+    for( int i = 0; i < 10; ++i ) {
+        field_spread_grid::spread_gases( m );
+    }
+    // Gas is moved around, but none is lost or made up.
+    CHECK( total_smoke( m ) == before );
+    int spread = 0;
+    for( const tripoint_bub_ms &p : m.points_in_radius( center, 8 ) ) {
+        const field_entry *smoke = m.get_field( p, fd_smoke );
+        if( smoke == nullptr || !smoke->is_field_alive() ) {
+            continue;
+        }
+        CHECK( smoke->get_field_intensity() <= fd_smoke->get_max_intensity() );
+        CHECK( m.ter( p ) == ter_t_floor );
+        if( rl_dist( p, center ) > 2 ) {
+            ++spread;
+        }
+    }
+    CHECK( spread > 0 );
+    clear_map();
+}
+
+TEST_CASE( "gas_spread_grid_matches_spreading_tile_by_tile", "[field]" )
+{
+    restore_on_out_of_scope restore_gas_spread_grid( gas_spread_grid );
+    const time_point before = calendar::turn;
+    map &m = get_map();
+    const tripoint_bub_ms center( 60, 60, 0 );
+
+    // A few clouds, each started from the same seed in both modes.
+    const auto spread_smoke = [&]( const bool grid ) {
+        gas_spread_grid = grid;
+        std::pair<int, int> smoke( 0, 0 );
+        for( int run = 0; run < 5; ++run ) {
+            rng_set_engine_seed( 1234 + run );
+            calendar::turn = before;
+            clear_map();
+            smoke_filled_room( m, center );
+            for( int i = 0; i < 20; ++i ) {
+                m.process_fields();
+                calendar::turn += 1_turns;
+            }
+            for_each_smoke( m, [&]( const tripoint_bub_ms & p, const field_entry & smoke_here ) {
+                CHECK( m.ter( p ) != ter_t_wall );
+                smoke.first += smoke_here.get_field_intensity();
+                ++smoke.second;
+            } );
+        }
+        return smoke;
+    };
+
+    // Total intensity and number of smoky tiles.
+    const std::pair<int, int> tile_by_tile = spread_smoke( false );
+    const std::pair<int, int> grid = spread_smoke( true );
+    // Every run starts with 25 smoky tiles, and the smoke should have spread beyond them.
+    CHECK( tile_by_tile.second > 5 * 25 );
+    CHECK( grid.second > 5 * 25 );
+    // Spreading only moves the smoke, so both lose about as much of it to decay.
+    CHECK( grid.first == Approx( tile_by_tile.first ).epsilon( 0.05 ) );
+
+    calendar::turn = before;
+    clear_map();
+}
+
+TEST_CASE( "gas_spreads_indoors_the_same_in_the_concurrent_passes", "[field][thread_pool]" )
+{
+    restore_on_out_of_scope restore_gas_spread_grid( gas_spread_grid );
+    restore_on_out_of_scope restore_windspeed( get_weather().windspeed );
+    const time_point before = calendar::turn;
+    map &m = get_map();
+    const tripoint_bub_ms center( 60, 60, 0 );
+    gas_spread_grid = false;
+    // The wind blows the smoke around on any tile wrongly taken to be outside.
+    get_weather().windspeed = 60;
+
+    const auto spread_smoke = [&]( const bool concurrent ) {
+        std::pair<int, int> smoke( 0, 0 );
+        for( int run = 0; run < 5; ++run ) {
+            rng_set_engine_seed( 1234 + run );
+            calendar::turn = before;
+            clear_map();
+            smoke_filled_room( m, center );
+            for( const tripoint_bub_ms &p : m.points_in_radius( center, 8 ) ) {
+                m.ter_set( p + tripoint_rel_ms::above, ter_t_floor );
+            }
+            m.build_map_cache( center.z(), true );
+            REQUIRE_FALSE( m.is_outside( center ) );
+            if( !concurrent ) {
+                // A drop of acid that never dries up keeps each submap of the room out of the
+                // concurrent passes.
+                std::set<point> submaps;
+                for( const tripoint_bub_ms &p : m.points_in_radius( center, 7 ) ) {
+                    if( submaps.emplace( p.x() / SEEX, p.y() / SEEY ).second ) {
+                        m.add_field( p, field_fd_acid, 1, -1_hours );
+                    }
+                }
+            }
+            for( int i = 0; i < 20; ++i ) {
+                m.process_fields();
+                calendar::turn += 1_turns;
+            }
+            for_each_smoke( m, [&]( const tripoint_bub_ms &, const field_entry & smoke_here ) {
+                smoke.first += smoke_here.get_field_intensity();
+                ++smoke.second;
+            } );
+        }
+        return smoke;
+    };
+
+    // Total intensity and number of smoky tiles.
+    const std::pair<int, int> serial = spread_smoke( false );
+    const std::pair<int, int> concurrent = spread_smoke( true );
+    CHECK( serial.second > 5 * 25 );
+    CHECK( concurrent.first == Approx( serial.first ).epsilon( 0.05 ) );
+    CHECK( concurrent.second == Approx( serial.second ).epsilon( 0.1 ) );
+
+    calendar::turn = before;
+    clear_map();
+}
@@ -1578,6 +1578,27 @@ static item *add_item_to_best_pocket( Character &dummy, const item &it )
     return ret;
 }
 
+TEST_CASE( "pocket_favorites_are_copied_by_value", "[pocket][favorite]" )
+{
+    item_pocket::favorite_settings settings;
+    REQUIRE( settings.is_null() );
+    REQUIRE( settings.is_unloadable() );
+    REQUIRE( settings.get_item_whitelist().empty() );
+
+    item_pocket::favorite_settings copy = settings;
+    copy.whitelist_item( itype_id( "rock" ) );
+    copy.set_priority( 5 );
+    CHECK_FALSE( copy.is_null() );
+    CHECK( settings.is_null() );
+    CHECK( settings.get_item_whitelist().empty() );
+    CHECK( settings.priority() == 0 );
+
+    item_pocket::favorite_settings copy_of_copy = copy;
+    copy_of_copy.clear_item( itype_id( "rock" ) );
+    CHECK( copy.get_item_whitelist().count( itype_id( "rock" ) ) == 1 );
+    CHECK( copy_of_copy.priority() == 5 );
+}
+
 // Character::best_pocket
 // - See if wielded item can hold it - start with this as default
 // - For each worn item, see if best_pocket is better; if so, use it
@@ -5,6 +5,9 @@
 #include <initializer_list>
 #include <limits>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <variant>
 #include <vector>
 
 #include "avatar.h"
@@ -15,7 +18,10 @@
 #include "game.h"
 #include "item_category.h"
 #include "item_factory.h"
+#include "item_var_map.h"
 #include "itype.h"
+#include "json.h"
+#include "json_loader.h"
 #include "math_defines.h"
 #include "monstergenerator.h"
 #include "mtype.h"
@@ -327,6 +333,50 @@ TEST_CASE( "item_variables_round-trip_accurately", "[item]" )
     CHECK( i.get_var( "C", tripoint_abs_omt::zero ) == tripoint_abs_omt( 2, 3, 4 ) );
 }
 
+TEST_CASE( "item_variables_keep_their_save_format", "[item][json]" )
+{
+    item_var_map vars;
+    vars.set( "count", 17LL );
+    vars.set( "ratio", 0.125 );
+    vars.set( "name", std::string( "0.5" ) );
+    vars.set( "padded", std::string( "007" ) );
+
+    std::ostringstream os;
+    JsonOut jsout( os );
+    vars.serialize( jsout );
+    const std::string saved = os.str();
+    CHECK( saved ==
+           R"({"count":"17","name":"0.5","padded":"007","ratio":"0.125000"})" );
+
+    item_var_map loaded;
+    loaded.deserialize( json_loader::from_string( saved ) );
+    CHECK( loaded == vars );
+    REQUIRE( loaded.find( "count" ) != nullptr );
+    CHECK( std::holds_alternative<long long>( *loaded.find( "count" ) ) );
+    REQUIRE( loaded.find( "padded" ) != nullptr );
+    CHECK( item_var_map::to_string( *loaded.find( "padded" ) ) == "007" );
+    REQUIRE( loaded.find( "name" ) != nullptr );
+    CHECK( item_var_map::to_string( *loaded.find( "name" ) ) == "0.5" );
+}
+
+TEST_CASE( "item_variables_decide_stacking", "[item]" )
+{
+    item A( "water" );
+    item B( "water" );
+    A.set_var( "shot_counter", 10 );
+    B.set_var( "shot_counter", 20 );
+    CHECK( A.stacks_with( B ) );
+    A.set_var( "charge", 3 );
+    CHECK_FALSE( A.stacks_with( B ) );
+    // Numbers and their string form are the same value.
+    B.set_var( "charge", std::string( "3" ) );
+    CHECK( A.stacks_with( B ) );
+    B.erase_var( "charge" );
+    A.erase_var( "charge" );
+    A.set_var( "item_note", std::string( "hello" ) );
+    CHECK_FALSE( A.stacks_with( B ) );
+}
+
 TEST_CASE( "water_affect_items_while_swimming_check", "[item][water][swimming]" )
 {
     avatar &guy = get_avatar();
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <list>
@@ -8,6 +9,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
@@ -20,11 +22,13 @@
 #include "damage.h"
 #include "debug.h"
 #include "enum_bitset.h"
+#include "filesystem.h"
 #include "item.h"
 #include "json.h"
 #include "json_loader.h"
 #include "magic.h"
 #include "mutation.h"
+#include "path_info.h"
 #include "sounds.h"
 #include "string_formatter.h"
 #include "translations.h"
@@ -947,3 +951,86 @@ TEST_CASE( "serialize_optional", "[json]" )
         test_serialization( v, "[1,2,3]" );
     }
 }
+
+TEST_CASE( "json_snapshot_follows_source_files", "[json]" )
+{
+    const cata_path dir = PATH_INFO::user_dir_path() / "json_snapshot_test";
+    const cata_path snapshot_dir = PATH_INFO::user_dir_path() / "cache" / "snapshots";
+    std::set<std::string> old_snapshots;
+    for( const cata_path &snapshot : get_files_from_path( ".snap", snapshot_dir, false, true ) ) {
+        old_snapshots.insert( snapshot.generic_u8string() );
+    }
+    // Remove the sources, their cached flexbuffers and the snapshots written by this test.
+    on_out_of_scope cleanup( [&]() {
+        std::error_code ec;
+        fs::remove_all( dir.get_unrelative_path(), ec );
+        fs::remove_all( ( PATH_INFO::user_dir_path() / "cache" /
+                          "json_snapshot_test" ).get_unrelative_path(), ec );
+        for( const cata_path &snapshot : get_files_from_path( ".snap", snapshot_dir, false, true ) ) {
+            if( !old_snapshots.count( snapshot.generic_u8string() ) ) {
+                remove_file( snapshot );
+            }
+        }
+    } );
+    REQUIRE( assure_dir_exist( dir ) );
+    const std::vector<cata_path> files = { dir / "a.json", dir / "b.json" };
+    const auto write_value = []( const cata_path & file, int value ) {
+        write_to_file( file, [value]( std::ostream & os ) {
+            os << R"({ "value": )" << value << " }";
+        } );
+    };
+    const auto read_values = [&]() {
+        std::vector<int> values;
+        for( const JsonValue &jv : json_loader::from_paths( dir, files, true ) ) {
+            values.push_back( jv.get_object().get_int( "value" ) );
+        }
+        return values;
+    };
+    write_value( files[0], 1 );
+    write_value( files[1], 2 );
+
+    // First call writes the snapshot, second one reads it back.
+    CHECK( read_values() == std::vector<int> { 1, 2 } );
+    CHECK( read_values() == std::vector<int> { 1, 2 } );
+
+    // Changing a file invalidates the snapshot.  Bump the mtime explicitly in case the
+    // rewrite happens within the same millisecond.
+    write_value( files[0], 3 );
+    const fs::path changed = files[0].get_unrelative_path();
+    fs::last_write_time( changed, fs::last_write_time( changed ) + std::chrono::seconds( 2 ) );
+    CHECK( read_values() == std::vector<int> { 3, 2 } );
+}
+
+TEST_CASE( "json_from_paths_reports_first_error", "[json]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    worker_threads = GENERATE( 1, 4 );
+    CAPTURE( worker_threads );
+
+    const cata_path dir = PATH_INFO::user_dir_path() / "json_from_paths_test";
+    on_out_of_scope cleanup( [&]() {
+        std::error_code ec;
+        fs::remove_all( dir.get_unrelative_path(), ec );
+        fs::remove_all( ( PATH_INFO::user_dir_path() / "cache" /
+                          "json_from_paths_test" ).get_unrelative_path(), ec );
+    } );
+    REQUIRE( assure_dir_exist( dir ) );
+    std::vector<cata_path> files;
+    for( int i = 0; i < 16; ++i ) {
+        files.push_back( dir / string_format( "file%d.json", i ) );
+        write_to_file( files.back(), [i]( std::ostream & os ) {
+            // Files 5 and 11 are malformed.
+            os << ( i == 5 || i == 11 ? "{ \"value\": }" : "{ \"value\": 1 }" );
+        } );
+    }
+
+    std::string error;
+    try {
+        json_loader::from_paths( dir, files, false );
+    } catch( const JsonError &e ) {
+        error = e.what();
+    }
+    CAPTURE( error );
+    CHECK( error.find( "file5.json" ) != std::string::npos );
+    CHECK( error.find( "file11.json" ) == std::string::npos );
+}
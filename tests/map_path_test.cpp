@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 #include "cata_catch.h"
 #include "coordinates.h"
 #include "coords_fwd.h"
 #include "game.h"
+#include "game_constants.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "pathfinding.h"
 #include "type_id.h"
 
 static void place_obstacle( map &m, const std::vector<tripoint_bub_ms> &places )
@@ -241,3 +247,200 @@ TEST_CASE( "find_clear_path_5tiles_with_obstacles", "[map]" )
     clear_map();
 }
 
+
+TEST_CASE( "route_reuses_routes_with_the_same_avoid_key", "[map][pathfinding]" )
+{
+    map &here = setup_map_without_obstacles();
+    // A wall between source and target, so that a plain straight line won't do.
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 5; y <= 15; ++y ) {
+        wall.emplace_back( 10, y, 0 );
+    }
+    place_obstacle( here, wall );
+
+    const tripoint_bub_ms source{ 3, 10, 0 };
+    const tripoint_bub_ms target{ 17, 10, 0 };
+    const pathfinding_settings settings( 0, 30, 60, 0, false, false, false, false, false, false );
+    int avoid_calls = 0;
+    const auto avoid = [&avoid_calls]( const tripoint_bub_ms & ) {
+        ++avoid_calls;
+        return false;
+    };
+
+    const std::vector<tripoint_bub_ms> route = here.route( source, target, settings, avoid, 1 );
+    REQUIRE( route.size() > 4 );
+    REQUIRE( route.back() == target );
+    CHECK( avoid_calls > 0 );
+
+    WHEN( "a creature on that route asks with the same key" ) {
+        avoid_calls = 0;
+        const std::vector<tripoint_bub_ms> rest = here.route( route[2], target, settings, avoid, 1 );
+        THEN( "it gets the rest of the route without a new search" ) {
+            CHECK( rest == std::vector<tripoint_bub_ms>( route.begin() + 3, route.end() ) );
+            CHECK( avoid_calls == 0 );
+        }
+    }
+    WHEN( "a creature on that route asks with another key" ) {
+        avoid_calls = 0;
+        here.route( route[2], target, settings, avoid, 2 );
+        THEN( "it searches for its own route" ) {
+            CHECK( avoid_calls > 0 );
+        }
+    }
+    WHEN( "the map changes inside the searched area" ) {
+        place_obstacle( here, { tripoint_bub_ms( 10, 4, 0 ) } );
+        avoid_calls = 0;
+        here.route( route[2], target, settings, avoid, 1 );
+        THEN( "the route is searched again" ) {
+            CHECK( avoid_calls > 0 );
+        }
+    }
+    clear_map();
+}
+
+TEST_CASE( "route_reads_flow_field_when_callers_converge", "[map][pathfinding]" )
+{
+    map &here = setup_map_without_obstacles();
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 5; y <= 15; ++y ) {
+        wall.emplace_back( 10, y, 0 );
+    }
+    place_obstacle( here, wall );
+
+    const tripoint_bub_ms target{ 17, 10, 0 };
+    const pathfinding_settings settings( 0, 30, 60, 0, false, false, false, false, false, false );
+    int avoid_calls = 0;
+    const auto avoid = [&avoid_calls]( const tripoint_bub_ms & ) {
+        ++avoid_calls;
+        return false;
+    };
+    const size_t key = 7;
+
+    // The second caller for the same target builds the field.
+    REQUIRE_FALSE( here.route( { 3, 6, 0 }, target, settings, avoid, key ).empty() );
+    REQUIRE_FALSE( here.route( { 3, 14, 0 }, target, settings, avoid, key ).empty() );
+
+    avoid_calls = 0;
+    const tripoint_bub_ms source{ 2, 10, 0 };
+    const std::vector<tripoint_bub_ms> route = here.route( source, target, settings, avoid, key );
+    CHECK( avoid_calls == 0 );
+    REQUIRE_FALSE( route.empty() );
+    CHECK( route.back() == target );
+    tripoint_bub_ms prev = source;
+    for( const tripoint_bub_ms &p : route ) {
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( std::find( wall.begin(), wall.end(), p ) == wall.end() );
+        prev = p;
+    }
+    clear_map();
+}
+
+TEST_CASE( "route_plans_across_submaps_when_the_search_box_is_too_small", "[map][pathfinding]" )
+{
+    map &here = get_map();
+    clear_map();
+    // A wall far longer than the area searched around source and target, with a gap at the end.
+    const int gap_y = 100;
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 0; y < gap_y; ++y ) {
+        wall.emplace_back( 30, y, 0 );
+    }
+    place_obstacle( here, wall );
+
+    const tripoint_bub_ms source{ 20, 30, 0 };
+    const tripoint_bub_ms target{ 40, 30, 0 };
+    const pathfinding_settings settings( 0, 100, 1000, 0, false, false, false, false, false, false );
+
+    const std::vector<tripoint_bub_ms> route = here.route( source, target, settings );
+    REQUIRE_FALSE( route.empty() );
+    CHECK( route.back() == target );
+    tripoint_bub_ms prev = source;
+    for( const tripoint_bub_ms &p : route ) {
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( std::find( wall.begin(), wall.end(), p ) == wall.end() );
+        prev = p;
+    }
+    CHECK( std::any_of( route.begin(), route.end(), []( const tripoint_bub_ms & p ) {
+        return p.y() >= gap_y;
+    } ) );
+
+    WHEN( "the gap is closed" ) {
+        std::vector<tripoint_bub_ms> rest;
+        for( int y = gap_y; y < here.getmapsize() * SEEY; ++y ) {
+            rest.emplace_back( 30, y, 0 );
+        }
+        place_obstacle( here, rest );
+        THEN( "there is no route" ) {
+            CHECK( here.route( source, target, settings ).empty() );
+        }
+    }
+    WHEN( "the gap is closed by a door" ) {
+        std::vector<tripoint_bub_ms> rest;
+        for( int y = gap_y + 1; y < here.getmapsize() * SEEY; ++y ) {
+            rest.emplace_back( 30, y, 0 );
+        }
+        place_obstacle( here, rest );
+        here.ter_set( tripoint_bub_ms( 30, gap_y, 0 ), ter_id( "t_door_c" ) );
+        THEN( "only those who can open doors get a route" ) {
+            CHECK( here.route( source, target, settings ).empty() );
+            pathfinding_settings opens_doors = settings;
+            opens_doors.allow_open_doors = true;
+            CHECK_FALSE( here.route( source, target, opens_doors ).empty() );
+        }
+    }
+    clear_map();
+}
+
+TEST_CASE( "route_benchmark", "[.][map][pathfinding][benchmark]" )
+{
+    map &here = get_map();
+    clear_map();
+    const pathfinding_settings settings( 0, 100, 1000, 0, false, false, false, false, false, false );
+    const std::function<bool( const tripoint_bub_ms & )> avoid_fn = []( const tripoint_bub_ms & ) {
+        return false;
+    };
+    const path_avoid_mask avoid_mask;
+
+    SECTION( "open field" ) {
+        // Just enough in the way that the straight line is blocked.
+        std::vector<tripoint_bub_ms> pillar;
+        for( int y = 28; y <= 32; ++y ) {
+            pillar.emplace_back( 40, y, 0 );
+        }
+        place_obstacle( here, pillar );
+        const tripoint_bub_ms source{ 10, 30, 0 };
+        const tripoint_bub_ms target{ 70, 30, 0 };
+        REQUIRE_FALSE( here.route( source, target, settings, avoid_fn ).empty() );
+
+        BENCHMARK( "std::function" ) {
+            return here.route( source, target, settings, avoid_fn );
+        };
+        BENCHMARK( "path_avoid_mask" ) {
+            return here.route( source, target, settings, avoid_mask );
+        };
+    }
+    SECTION( "maze" ) {
+        // Walls across the whole search area, each open at the opposite end from the last.
+        std::vector<tripoint_bub_ms> walls;
+        for( int x = 14; x <= 66; x += 4 ) {
+            const int gap_y = x % 8 == 0 ? 16 : 44;
+            for( int y = 0; y < 60; ++y ) {
+                if( y != gap_y ) {
+                    walls.emplace_back( x, y, 0 );
+                }
+            }
+        }
+        place_obstacle( here, walls );
+        const tripoint_bub_ms source{ 10, 30, 0 };
+        const tripoint_bub_ms target{ 70, 30, 0 };
+        REQUIRE_FALSE( here.route( source, target, settings, avoid_fn ).empty() );
+
+        BENCHMARK( "std::function" ) {
+            return here.route( source, target, settings, avoid_fn );
+        };
+        BENCHMARK( "path_avoid_mask" ) {
+            return here.route( source, target, settings, avoid_mask );
+        };
+    }
+    clear_map();
+}
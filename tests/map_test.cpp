@@ -1,15 +1,20 @@
 #include "cata_catch.h"
 #include "map.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "avatar.h"
+#include "cached_options.h"
+#include "cata_scope_helpers.h"
 #include "coordinates.h"
 #include "enums.h"
 #include "itype.h"
 #include "game.h"
 #include "game_constants.h"
+#include "level_cache.h"
 #include "map_helpers.h"
 #include "point.h"
 #include "submap.h"
@@ -302,3 +307,92 @@ TEST_CASE( "active_monster_drops", "[active_item][map]" )
     }
     CHECK( dropped_bag.empty() );
 }
+
+TEST_CASE( "build_map_cache_is_independent_of_worker_threads", "[map][thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    map &here = get_map();
+    clear_map();
+    const ter_id t_wall( "t_wall" );
+    const ter_id t_open_air( "t_open_air" );
+    for( int x = 10; x < 20; ++x ) {
+        here.ter_set( tripoint_bub_ms( x, 10, 0 ), t_wall );
+        here.ter_set( tripoint_bub_ms( x, 20, 1 ), t_open_air );
+    }
+
+    const auto build = [&here]( const int threads ) {
+        worker_threads = threads;
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+            here.set_outside_cache_dirty( z );
+            here.set_transparency_cache_dirty( z );
+            here.set_floor_cache_dirty( z );
+        }
+        here.build_map_cache( 0, true );
+        std::vector<float> transparency;
+        std::vector<bool> floors;
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+            const level_cache &ch = here.access_cache( z );
+            for( int x = 0; x < MAPSIZE_X; ++x ) {
+                for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                    transparency.push_back( ch.vision_transparency_cache[x][y] );
+                    floors.push_back( ch.floor_cache[x][y] );
+                }
+            }
+        }
+        return std::make_pair( transparency, floors );
+    };
+
+    const std::pair<std::vector<float>, std::vector<bool>> serial = build( 1 );
+    const std::pair<std::vector<float>, std::vector<bool>> parallel = build( 4 );
+    CHECK_FALSE( here.is_transparent( tripoint_bub_ms( 15, 10, 0 ) ) );
+    CHECK_FALSE( here.has_floor( tripoint_bub_ms( 15, 20, 1 ) ) );
+    CHECK( serial.first == parallel.first );
+    CHECK( serial.second == parallel.second );
+    clear_map();
+}
+
+TEST_CASE( "cached_sight_lines_match_sees", "[map][vision][thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    map &here = get_map();
+    clear_map();
+    const ter_id t_wall( "t_wall" );
+    for( int x = 40; x <= 80; ++x ) {
+        for( int y = 40; y <= 80; ++y ) {
+            if( ( x * 7 + y * 3 ) % 11 == 0 ) {
+                here.ter_set( tripoint_bub_ms( x, y, 0 ), t_wall );
+            }
+        }
+    }
+    const auto clear_sight_cache = [&here]() {
+        here.set_seen_cache_dirty( 0 );
+        here.build_map_cache( 0, true );
+    };
+    clear_sight_cache();
+
+    std::vector<map::sight_line> lines;
+    for( const tripoint_bub_ms &from : {
+             tripoint_bub_ms( 60, 61, 0 ), tripoint_bub_ms( 47, 72, 0 )
+         } ) {
+        for( int x = 42; x <= 78; ++x ) {
+            for( int y = 42; y <= 78; ++y ) {
+                lines.emplace_back( from, tripoint_bub_ms( x, y, 0 ) );
+            }
+        }
+    }
+    std::vector<bool> expected;
+    for( const map::sight_line &line : lines ) {
+        expected.push_back( here.sees( line.first, line.second, -1 ) );
+    }
+    REQUIRE( std::count( expected.begin(), expected.end(), false ) > 0 );
+
+    clear_sight_cache();
+    worker_threads = 4;
+    here.cache_sight_lines( lines );
+    std::vector<bool> cached;
+    for( const map::sight_line &line : lines ) {
+        cached.push_back( here.sees( line.first, line.second, -1 ) );
+    }
+    CHECK( cached == expected );
+    clear_map();
+}
@@ -0,0 +1,296 @@
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <system_error>
+
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "cata_utility.h"
+#include "coordinates.h"
+#include "filesystem.h"
+#include "json.h"
+#include "mapbuffer.h"
+#include "path_info.h"
+#include "point.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_dirt( "t_dirt" );
+static const ter_str_id ter_t_floor( "t_floor" );
+static const ter_str_id ter_t_grass( "t_grass" );
+
+// NOLINTNEXTLINE(cata-static-declarations)
+extern const int savegame_version;
+
+// Far away from the reality bubble of the tests, in a segment of its own.
+static const tripoint_abs_omt quad_a( 100, 100, 0 );
+static const tripoint_abs_omt quad_b( 101, 100, 0 );
+
+static const point_sm_ms marked_tile( 1, 0 );
+
+static cata_path segment_dir( const tripoint_abs_omt &om_addr )
+{
+    const tripoint_abs_seg segment_addr = project_to<coords::seg>( om_addr );
+    return PATH_INFO::world_base_save_path() / "maps" / string_format( "%d.%d.%d",
+            segment_addr.x(), segment_addr.y(), segment_addr.z() );
+}
+
+static cata_path legacy_quad_path( const tripoint_abs_omt &om_addr )
+{
+    return segment_dir( om_addr ) / string_format( "%d.%d.%d.map", om_addr.x(), om_addr.y(),
+            om_addr.z() );
+}
+
+static size_t file_size( const cata_path &path )
+{
+    return static_cast<size_t>( fs::file_size( path.get_unrelative_path() ) );
+}
+
+// Every other tile carries the mark, so the terrain does not compress into a few runs.
+static std::unique_ptr<submap> marked_submap( const ter_str_id &mark )
+{
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    sm->set_all_ter( ter_t_dirt );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            if( ( x + y ) % 2 == 1 ) {
+                sm->set_ter( point_sm_ms( x, y ), mark );
+            }
+        }
+    }
+    return sm;
+}
+
+static void add_quad( mapbuffer &buffer, const tripoint_abs_omt &om_addr, const ter_str_id &mark )
+{
+    const tripoint_abs_sm origin = project_to<coords::sm>( om_addr );
+    for( const point &offset : {
+             point::zero, point::south, point::east, point::south_east
+         } ) {
+        std::unique_ptr<submap> sm = marked_submap( mark );
+        REQUIRE( buffer.add_submap( origin + offset, sm ) );
+    }
+}
+
+// Loads the quad the way a new game session would, with nothing in memory yet.
+static std::optional<ter_str_id> stored_mark( const tripoint_abs_omt &om_addr )
+{
+    mapbuffer buffer;
+    const submap *sm = buffer.lookup_submap( project_to<coords::sm>( om_addr ) + point::south_east );
+    if( sm == nullptr ) {
+        return std::nullopt;
+    }
+    return sm->get_ter( marked_tile ).id();
+}
+
+// The format of the files that held one quad each before the segment packs.
+static void write_legacy_quad( const tripoint_abs_omt &om_addr, const ter_str_id &mark )
+{
+    assure_dir_exist( segment_dir( om_addr ) );
+    write_to_file( legacy_quad_path( om_addr ), [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_array();
+        const tripoint_abs_sm origin = project_to<coords::sm>( om_addr );
+        for( const point &offset : {
+                 point::zero, point::south, point::east, point::south_east
+             } ) {
+            const tripoint_abs_sm submap_addr = origin + offset;
+            jsout.start_object();
+            jsout.member( "version", savegame_version );
+            jsout.member( "coordinates" );
+            jsout.start_array();
+            jsout.write( submap_addr.x() );
+            jsout.write( submap_addr.y() );
+            jsout.write( submap_addr.z() );
+            jsout.end_array();
+            marked_submap( mark )->store( jsout );
+            jsout.end_object();
+        }
+        jsout.end_array();
+    } );
+}
+
+static on_out_of_scope clean_segment_dir()
+{
+    const cata_path dir = segment_dir( quad_a );
+    std::error_code ec;
+    fs::remove_all( dir.get_unrelative_path(), ec );
+    return on_out_of_scope( [dir]() {
+        std::error_code ec;
+        fs::remove_all( dir.get_unrelative_path(), ec );
+    } );
+}
+
+TEST_CASE( "mapbuffer_saves_and_loads_quads_through_the_segment_pack", "[mapbuffer]" )
+{
+    on_out_of_scope cleanup = clean_segment_dir();
+    const cata_path dir = segment_dir( quad_a );
+
+    mapbuffer buffer;
+    add_quad( buffer, quad_a, ter_t_floor );
+    add_quad( buffer, quad_b, ter_t_grass );
+    buffer.save( true );
+
+    CHECK( file_exist( dir / "quads.pack" ) );
+    CHECK( file_exist( dir / "quads.idx" ) );
+    CHECK_FALSE( file_exist( legacy_quad_path( quad_a ) ) );
+    CHECK( stored_mark( quad_a ) == ter_t_floor );
+    CHECK( stored_mark( quad_b ) == ter_t_grass );
+
+    SECTION( "a later save replaces the quad" ) {
+        add_quad( buffer, quad_a, ter_t_grass );
+        buffer.save( true );
+        CHECK( stored_mark( quad_a ) == ter_t_grass );
+        CHECK( stored_mark( quad_b ) == ter_t_grass );
+    }
+
+    SECTION( "a quad reverted to uniform terrain is no longer loaded" ) {
+        REQUIRE( buffer.lookup_submap( project_to<coords::sm>( quad_a ) ) != nullptr );
+        for( auto &elem : buffer ) {
+            if( project_to<coords::omt>( elem.first ) == quad_a ) {
+                elem.second = std::make_unique<submap>();
+                elem.second->reverted = true;
+            }
+        }
+        buffer.save( true );
+        CHECK_FALSE( stored_mark( quad_a ) );
+        CHECK( stored_mark( quad_b ) == ter_t_grass );
+    }
+}
+
+TEST_CASE( "mapbuffer_finds_records_appended_after_the_index_was_written", "[mapbuffer]" )
+{
+    on_out_of_scope cleanup = clean_segment_dir();
+    const cata_path index_path = segment_dir( quad_a ) / "quads.idx";
+
+    mapbuffer buffer;
+    add_quad( buffer, quad_a, ter_t_floor );
+    buffer.save( true );
+    const std::optional<std::string> old_index = read_whole_file( index_path );
+    REQUIRE( old_index );
+
+    // A save that stopped between appending its records and writing the index.
+    add_quad( buffer, quad_a, ter_t_grass );
+    add_quad( buffer, quad_b, ter_t_grass );
+    buffer.save( true );
+    write_to_file( index_path, [&]( std::ostream & fout ) {
+        fout << *old_index;
+    } );
+
+    CHECK( stored_mark( quad_a ) == ter_t_grass );
+    CHECK( stored_mark( quad_b ) == ter_t_grass );
+}
+
+TEST_CASE( "mapbuffer_cuts_off_a_damaged_record_at_the_end_of_the_pack", "[mapbuffer]" )
+{
+    on_out_of_scope cleanup = clean_segment_dir();
+    const cata_path dir = segment_dir( quad_a );
+    const cata_path pack_path = dir / "quads.pack";
+
+    {
+        mapbuffer buffer;
+        add_quad( buffer, quad_a, ter_t_floor );
+        buffer.save( true );
+    }
+    const size_t intact_size = file_size( pack_path );
+
+    SECTION( "with an index" ) {
+    }
+    SECTION( "without an index" ) {
+        remove_file( dir / "quads.idx" );
+    }
+
+    // The start of a record whose json was never written completely.
+    {
+        std::ofstream fout( pack_path.get_unrelative_path(), std::ios::binary | std::ios::app );
+        fout << string_format( "%d %d %d 5000\n[{\"damaged\"", quad_b.x(), quad_b.y(), quad_b.z() );
+    }
+
+    CHECK( stored_mark( quad_a ) == ter_t_floor );
+    CHECK_FALSE( stored_mark( quad_b ) );
+
+    mapbuffer buffer;
+    add_quad( buffer, quad_b, ter_t_grass );
+    buffer.save( true );
+
+    CHECK( stored_mark( quad_a ) == ter_t_floor );
+    CHECK( stored_mark( quad_b ) == ter_t_grass );
+    const std::optional<std::string> data = read_whole_file( pack_path );
+    REQUIRE( data );
+    CHECK( data->find( "damaged" ) == std::string::npos );
+    CHECK( data->size() > intact_size );
+}
+
+TEST_CASE( "mapbuffer_compacts_a_pack_of_superseded_records", "[mapbuffer]" )
+{
+    on_out_of_scope cleanup = clean_segment_dir();
+    const cata_path pack_path = segment_dir( quad_a ) / "quads.pack";
+
+    // A row of quads across the segment, saved over and over again.
+    const auto add_row = []( mapbuffer & buffer, const ter_str_id & mark ) {
+        for( int x = 96; x < 128; x++ ) {
+            add_quad( buffer, tripoint_abs_omt( x, quad_a.y(), quad_a.z() ), mark );
+        }
+    };
+
+    mapbuffer buffer;
+    add_row( buffer, ter_t_floor );
+    buffer.save( true );
+    const size_t live_size = file_size( pack_path );
+
+    size_t pack_size = live_size;
+    ter_str_id mark = ter_t_floor;
+    bool compacted = false;
+    for( int i = 0; i < 50 && !compacted; i++ ) {
+        mark = mark == ter_t_floor ? ter_t_grass : ter_t_floor;
+        add_row( buffer, mark );
+        buffer.save( true );
+        const size_t new_size = file_size( pack_path );
+        compacted = new_size < pack_size;
+        pack_size = new_size;
+    }
+    REQUIRE( compacted );
+    CHECK( pack_size == live_size );
+
+    for( int x = 96; x < 128; x++ ) {
+        CHECK( stored_mark( tripoint_abs_omt( x, quad_a.y(), quad_a.z() ) ) == mark );
+    }
+}
+
+TEST_CASE( "mapbuffer_moves_legacy_quad_files_into_the_segment_pack", "[mapbuffer]" )
+{
+    on_out_of_scope cleanup = clean_segment_dir();
+
+    write_legacy_quad( quad_a, ter_t_floor );
+    write_legacy_quad( quad_b, ter_t_floor );
+    CHECK( stored_mark( quad_a ) == ter_t_floor );
+
+    mapbuffer buffer;
+    REQUIRE( buffer.lookup_submap( project_to<coords::sm>( quad_a ) ) != nullptr );
+    REQUIRE( buffer.lookup_submap( project_to<coords::sm>( quad_b ) ) != nullptr );
+
+    SECTION( "a saved quad replaces its file" ) {
+        buffer.save( true );
+        CHECK_FALSE( file_exist( legacy_quad_path( quad_a ) ) );
+        CHECK_FALSE( file_exist( legacy_quad_path( quad_b ) ) );
+        CHECK( stored_mark( quad_a ) == ter_t_floor );
+        CHECK( stored_mark( quad_b ) == ter_t_floor );
+    }
+
+    SECTION( "a quad reverted to uniform terrain loses its file" ) {
+        for( auto &elem : buffer ) {
+            if( project_to<coords::omt>( elem.first ) == quad_a ) {
+                elem.second = std::make_unique<submap>();
+                elem.second->reverted = true;
+            }
+        }
+        buffer.save( true );
+        CHECK_FALSE( file_exist( legacy_quad_path( quad_a ) ) );
+        CHECK_FALSE( stored_mark( quad_a ) );
+        CHECK( stored_mark( quad_b ) == ter_t_floor );
+    }
+}
@@ -7,6 +7,7 @@
 #include "type_id.h"
 #include "weather.h"
 
+static const flag_id json_flag_COLD( "COLD" );
 static const flag_id json_flag_FROZEN( "FROZEN" );
 
 static void set_map_temperature( units::temperature new_temperature )
@@ -134,3 +135,45 @@ TEST_CASE( "Hourly_rotpoints", "[rot]" )
     CHECK( normal_item.calc_hourly_rotpoints_at_temp( units::from_fahrenheit( 107 ) ) == Approx(
                20364.67 ) );
 }
+
+TEST_CASE( "Food_is_processed_again_before_it_changes", "[rot]" )
+{
+    if( calendar::turn <= calendar::start_of_cataclysm ) {
+        calendar::turn = calendar::start_of_cataclysm + 1_minutes;
+    }
+    set_map_temperature( units::from_fahrenheit( 65 ) );
+    item food( "meat_cooked" );
+    // Process item once to set all of its values.
+    food.process( get_map(), nullptr, tripoint_bub_ms::zero, 1, temperature_flag::NORMAL );
+    const time_point start = calendar::turn;
+
+    SECTION( "nothing changes within the hour" ) {
+        CHECK( food.next_state_change( tripoint_bub_ms::zero, 1 ) == start + 1_hours );
+    }
+    SECTION( "about to become rotten" ) {
+        food.set_rot( food.get_shelf_life() - 30_minutes );
+        // At 65 F food rots at a rate of 1h/1h.
+        CHECK( to_turns<int>( food.next_state_change( tripoint_bub_ms::zero, 1 ) - start ) ==
+               Approx( to_turns<int>( 30_minutes ) ).margin( 1 ) );
+    }
+    SECTION( "does not rot in a sealed container" ) {
+        food.set_rot( food.get_shelf_life() - 30_minutes );
+        CHECK( food.next_state_change( tripoint_bub_ms::zero, 1, temperature_flag::NORMAL, 0 ) ==
+               start + 1_hours );
+    }
+    SECTION( "cools down in the freezer" ) {
+        // Poorly insulated, so that it gets cold well within the hour.
+        const float insulation = 0.5f;
+        const time_point cold = food.next_state_change( tripoint_bub_ms::zero, insulation,
+                                temperature_flag::FREEZER );
+        REQUIRE( cold < start + 50_minutes );
+        item before = food;
+        item after = food;
+        before.advance_to( cold - 2_minutes, insulation, tripoint_bub_ms::zero, get_map(), nullptr,
+                           temperature_flag::FREEZER );
+        after.advance_to( cold + 2_minutes, insulation, tripoint_bub_ms::zero, get_map(), nullptr,
+                          temperature_flag::FREEZER );
+        CHECK( !before.has_own_flag( json_flag_COLD ) );
+        CHECK( after.has_own_flag( json_flag_COLD ) );
+    }
+}
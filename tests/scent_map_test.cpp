@@ -0,0 +1,216 @@
+#include <memory>
+#include <random>
+
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "rng.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_floor( "t_floor" );
+static const ter_str_id ter_t_stairs_down( "t_stairs_down" );
+static const ter_str_id ter_t_stairs_up( "t_stairs_up" );
+
+template<typename T>
+using scent_array = scent_map::scent_array<T>;
+
+namespace
+{
+
+struct scent_fixture {
+    scent_array<int> scent;
+    scent_array<bool> blocks;
+    scent_array<bool> reduces;
+};
+
+} // namespace
+
+static constexpr point scent_min( 20, 20 );
+static constexpr point scent_max( MAPSIZE_X - 21, MAPSIZE_Y - 21 );
+
+// The diffusion step as it was written before it was rearranged for vectorization, with the
+// y sums held in transposed arrays.  Kept to check that the results did not change.
+static void reference_diffuse( scent_array<int> &grscent, const scent_array<bool> &blocks_scent,
+                               const scent_array<bool> &reduces_scent,
+                               const point &min, const point &max )
+{
+    const int diffusivity = 100;
+    std::unique_ptr<scent_array<int>> sum_3_scent_y = std::make_unique<scent_array<int>>();
+    std::unique_ptr<scent_array<int>> squares_used_y = std::make_unique<scent_array<int>>();
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            ( *sum_3_scent_y )[y][x] = 0;
+            ( *squares_used_y )[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks_scent[x][i] ) {
+                    if( reduces_scent[x][i] ) {
+                        ( *sum_3_scent_y )[y][x] += 2 * grscent[x][i];
+                        ( *squares_used_y )[y][x] += 2;
+                    } else {
+                        ( *sum_3_scent_y )[y][x] += 10 * grscent[x][i];
+                        ( *squares_used_y )[y][x] += 10;
+                    }
+                }
+            }
+        }
+    }
+
+    for( int x = min.x; x <= max.x; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            int &scent_here = grscent[x][y];
+            if( !blocks_scent[x][y] ) {
+                const int squares_used = ( *squares_used_y )[y][x - 1]
+                                         + ( *squares_used_y )[y][x]
+                                         + ( *squares_used_y )[y][x + 1];
+                const int this_diffusivity = reduces_scent[x][y] ? diffusivity / 5 : diffusivity;
+                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+                scent_here =
+                    ( temp_scent
+                      + this_diffusivity * ( ( *sum_3_scent_y )[y][x - 1]
+                                             + ( *sum_3_scent_y )[y][x]
+                                             + ( *sum_3_scent_y )[y][x + 1] )
+                    ) / ( 1000 * 10 );
+            } else {
+                scent_here = 0;
+            }
+        }
+    }
+}
+
+static std::unique_ptr<scent_fixture> random_scent()
+{
+    std::unique_ptr<scent_fixture> f = std::make_unique<scent_fixture>();
+    std::uniform_int_distribution<int> scent_dist( 0, 10000 );
+    std::uniform_int_distribution<int> flag_dist( 0, 9 );
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            f->scent[x][y] = scent_dist( rng_get_engine() );
+            const int flag = flag_dist( rng_get_engine() );
+            f->blocks[x][y] = flag == 0;
+            f->reduces[x][y] = flag == 1;
+        }
+    }
+    return f;
+}
+
+TEST_CASE( "scent_diffusion_matches_reference_implementation", "[scent]" )
+{
+    std::unique_ptr<scent_fixture> f = random_scent();
+    std::unique_ptr<scent_array<int>> expected = std::make_unique<scent_array<int>>( f->scent );
+    // Several steps, so that blocked squares and the border are read back as well.
+    for( int i = 0; i < 5; ++i ) {
+        reference_diffuse( *expected, f->blocks, f->reduces, scent_min, scent_max );
+        scent_map::diffuse( f->scent, f->blocks, f->reduces, scent_min, scent_max );
+    }
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            if( f->scent[x][y] != ( *expected )[x][y] ) {
+                ++mismatches;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "scent_spreads_between_levels_where_they_connect", "[scent]" )
+{
+    clear_map( -1, 1 );
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+    const tripoint_bub_ms source( 60, 60, 0 );
+    const tripoint_bub_ms below = source + tripoint::below;
+    const tripoint_bub_ms above = source + tripoint::above;
+
+    const auto spread_scent = [&]() {
+        for( int turn = 0; turn < 10; ++turn ) {
+            scent.set( source.raw(), 500 );
+            scent.update( source.raw(), here );
+        }
+    };
+
+    SECTION( "stairs carry scent down" ) {
+        here.ter_set( source, ter_t_stairs_down );
+        here.ter_set( below, ter_t_stairs_up );
+        // The level below is solid rock, which blocks scent, so dig a corridor.
+        here.ter_set( below + tripoint::east, ter_t_floor );
+        spread_scent();
+        CHECK( scent.get( below ) > 0 );
+        CHECK( scent.get( below + tripoint::east ) > 0 );
+    }
+    SECTION( "solid ground does not" ) {
+        spread_scent();
+        CHECK( scent.get( below ) == 0 );
+    }
+    SECTION( "a hole in the ceiling carries scent up" ) {
+        here.ter_set( source, ter_t_floor );
+        spread_scent();
+        CHECK( scent.get( above ) > 0 );
+    }
+    SECTION( "the sky over open ground does not" ) {
+        spread_scent();
+        CHECK( scent.get( above ) == 0 );
+    }
+    scent.reset();
+}
+
+TEST_CASE( "outdoor_scent_trail_keeps_its_strength", "[scent]" )
+{
+    clear_map( -1, 1 );
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+    const tripoint_bub_ms center( 60, 60, 0 );
+    // The area scent_map::update diffuses around its center.
+    const point update_min = center.xy().raw() - point( 40, 40 );
+    const point update_max = center.xy().raw() + point( 40, 40 );
+
+    // The same trail left on a lone level, which is how scent spread before levels were linked.
+    std::unique_ptr<scent_array<int>> expected = std::make_unique<scent_array<int>>();
+    std::unique_ptr<scent_array<bool>> nothing = std::make_unique<scent_array<bool>>();
+    for( auto &col : *expected ) {
+        col.fill( 0 );
+    }
+    for( auto &col : *nothing ) {
+        col.fill( false );
+    }
+    for( int turn = 0; turn < 10; ++turn ) {
+        const tripoint_bub_ms p = center + tripoint_rel_ms( turn - 5, 0, 0 );
+        scent.set( p.raw(), 500 );
+        ( *expected )[p.x()][p.y()] = 500;
+        scent.update( center.raw(), here );
+        scent_map::diffuse( *expected, *nothing, *nothing, update_min, update_max );
+    }
+
+    int mismatches = 0;
+    for( int x = update_min.x; x <= update_max.x; ++x ) {
+        for( int y = update_min.y; y <= update_max.y; ++y ) {
+            if( scent.get( tripoint_bub_ms( x, y, 0 ) ) != ( *expected )[x][y] ) {
+                ++mismatches;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+    CHECK( scent.get( center + tripoint::above ) == 0 );
+    scent.reset();
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.][scent][benchmark]" )
+{
+    std::unique_ptr<scent_fixture> f = random_scent();
+
+    BENCHMARK( "reference" ) {
+        reference_diffuse( f->scent, f->blocks, f->reduces, scent_min, scent_max );
+        return f->scent[MAPSIZE_X / 2][MAPSIZE_Y / 2];
+    };
+    BENCHMARK( "diffuse" ) {
+        scent_map::diffuse( f->scent, f->blocks, f->reduces, scent_min, scent_max );
+        return f->scent[MAPSIZE_X / 2][MAPSIZE_Y / 2];
+    };
+}
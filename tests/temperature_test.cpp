@@ -6,6 +6,7 @@
 #include "game_constants.h"
 #include "item.h"
 #include "map.h"
+#include "map_helpers.h"
 #include "point.h"
 #include "weather.h"
 
@@ -290,3 +291,27 @@ TEST_CASE( "Temperature_controlled_location", "[temperature]" )
                     temperatures::normal ) ) );
     }
 }
+
+TEST_CASE( "Temperatures_are_cached_until_the_next_turn", "[temperature]" )
+{
+    clear_map( -1, 0 );
+    weather_manager &weather = get_weather();
+    const units::temperature old_temperature = weather.temperature;
+    const tripoint looked_up( 60, 60, 0 );
+    const tripoint not_looked_up( 61, 60, 0 );
+    const tripoint underground( 60, 60, -1 );
+
+    set_map_temperature( units::from_fahrenheit( 50 ) );
+    CHECK( units::to_fahrenheit( weather.get_temperature( looked_up ) ) == Approx( 50 ) );
+    CHECK( weather.get_temperature( underground ) == AVERAGE_ANNUAL_TEMPERATURE );
+
+    weather.temperature = units::from_fahrenheit( 80 );
+    CHECK( units::to_fahrenheit( weather.get_temperature( looked_up ) ) == Approx( 50 ) );
+    CHECK( units::to_fahrenheit( weather.get_temperature( not_looked_up ) ) == Approx( 80 ) );
+
+    weather.clear_temp_cache();
+    CHECK( units::to_fahrenheit( weather.get_temperature( looked_up ) ) == Approx( 80 ) );
+    CHECK( weather.get_temperature( underground ) == AVERAGE_ANNUAL_TEMPERATURE );
+
+    set_map_temperature( old_temperature );
+}
@@ -14,7 +14,9 @@
 #include "cata_scope_helpers.h"
 #include "character.h"
 #include "game.h"
+#include "game_constants.h"
 #include "item.h"
+#include "level_cache.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "map_test_case.h"
@@ -1171,3 +1173,37 @@ TEST_CASE( "pl_sees-oob-nocrash", "[vision]" )
 
     clear_avatar();
 }
+
+TEST_CASE( "lightmap_is_independent_of_worker_threads", "[vision][thread_pool]" )
+{
+    restore_on_out_of_scope restore_worker_threads( worker_threads );
+    restore_on_out_of_scope restore_turn( calendar::turn );
+    calendar::turn = midnight;
+    clear_map();
+    map &here = get_map();
+    // Enough light sources to be split between the workers, with walls casting shadows.
+    for( int x = 5; x < MAPSIZE_X - 5; x += 6 ) {
+        for( int y = 5; y < MAPSIZE_Y - 5; y += 6 ) {
+            here.ter_set( tripoint_bub_ms( x, y, 0 ), ter_t_utility_light );
+            here.ter_set( tripoint_bub_ms( x + 2, y + 1, 0 ), ter_t_brick_wall );
+        }
+    }
+
+    const auto light = [&here]( const int threads ) {
+        worker_threads = threads;
+        here.build_map_cache( 0 );
+        std::vector<float> values;
+        const level_cache &ch = here.access_cache( 0 );
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                values.insert( values.end(), ch.lm[x][y].values.begin(), ch.lm[x][y].values.end() );
+                values.push_back( ch.sm[x][y] );
+            }
+        }
+        return values;
+    };
+    const std::vector<float> serial = light( 1 );
+    CHECK( here.light_at( tripoint_bub_ms( 5, 5, 0 ) ) != lit_level::DARK );
+    CHECK( light( 4 ) == serial );
+    clear_map();
+}